@@ -1,17 +1,152 @@
 #include "DsmcParticleContainer.H"
+#include "CounterRNG.H"
 #include <math.h>
 
-int FhdParticleContainer::getSpeciesIndex(int species1, int species2)
+// The selections and collisions of a cell only touch the particles of that
+// cell and its mfselect/mfvrmax entries, so cells are processed concurrently
+// (GPU threads, or OpenMP threads over the cells of a grid).  Each cell draws
+// from its own counter-based stream, keyed on collideSeed and indexed by the
+// global cell index, the step and the phase (0 = selections, 1 = collisions),
+// so the result does not depend on the number of threads or the order of the
+// cells.
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+int DsmcSpeciesIndex (int species1, int species2, int ns)
+{
+	return (species1<species2) ? species2+ns*species1 : species1+ns*species2;
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+PhiloxStream DsmcCellStream (Long seed, int step, int phase, Long cell)
+{
+	const GpuArray<std::uint32_t,2> key = {static_cast<std::uint32_t>(seed),
+	                                       static_cast<std::uint32_t>(seed >> 32)};
+	return PhiloxStream(key, static_cast<std::uint32_t>(cell),
+	                    static_cast<std::uint32_t>(cell >> 32),
+	                    static_cast<std::uint32_t>(2*step+phase));
+}
+
+// Run f(i,j,k) for every cell of bx: a GPU launch, or OpenMP threads over
+// the cells on the CPU.
+template <typename F>
+static void DsmcForEachCell (const Box& bx, F&& f)
+{
+#ifdef AMREX_USE_GPU
+	amrex::ParallelFor(bx, std::forward<F>(f));
+#else
+	const Long ncell = bx.numPts();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+	for (Long imap = 0; imap < ncell; imap++)
+	{
+		const IntVect iv = bx.atOffset(imap);
+		f(iv[0], iv[1], iv[2]);
+	}
+#endif
+}
+
+// Perform the selected collisions of cell (i,j,k), which is cell imap of
+// the cell index.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+void DsmcCollideCell (int i, int j, int k, Long imap, const DsmcCellList& cells,
+                      FhdParticleContainer::ParticleType* pstruct,
+                      const Array4<const Real>& arrselect, const Array4<Real>& arrvrmax,
+                      const GpuArray<Real,MAX_SPECIES>& mass, const int ns, const Real pi,
+                      PhiloxStream& rng)
 {
-	if(species1<species2)
+	Real NSel[MAX_SPECIES*MAX_SPECIES];
+	Real totalSel = 0;
+	for(int i_spec = 0; i_spec<ns; i_spec++)
 	{
-		return species2+nspecies*species1;
-	} else
+		for (int j_spec = i_spec; j_spec < ns; j_spec++)
+		{
+			int ij_spec = DsmcSpeciesIndex(i_spec,j_spec,ns);
+			NSel[ij_spec] = (int)arrselect(i,j,k,ij_spec);
+			totalSel += NSel[ij_spec];
+		}
+	}
+
+	while (totalSel>0)
 	{
-		return species1+nspecies*species2;
+		// pick the species pair with probability NSel/totalSel
+		Real RR = rng.Random();
+		Real selrun = 0;
+		int speci = -1, specj = -1, specij = -1;
+		for(int i_spec = 0; i_spec<ns; i_spec++)
+		{
+			for(int j_spec=i_spec;j_spec<ns;j_spec++)
+			{
+				int ij_spec = DsmcSpeciesIndex(i_spec,j_spec,ns);
+				selrun += NSel[ij_spec];
+				if(selrun/totalSel>RR && specij == -1)
+				{
+					specij = ij_spec;
+					speci = i_spec; specj = j_spec;
+					NSel[ij_spec] -= 1;
+				}
+			}
+		}
+		totalSel--;
+
+		Real massi = mass[speci];
+		Real massj = mass[specj];
+		Real massij = mass[speci] + mass[specj];
+		Real vrmax = arrvrmax(i,j,k,specij);
+		int pindxi = cells.particles(speci,imap)[(int)floor(rng.Random()*cells.numParticles(speci,imap))];
+		int pindxj = cells.particles(specj,imap)[(int)floor(rng.Random()*cells.numParticles(specj,imap))];
+
+		FhdParticleContainer::ParticleType & parti = pstruct[pindxi];
+		FhdParticleContainer::ParticleType & partj = pstruct[pindxj];
+
+		Real vi[3], vj[3], vij[3], eij[3], vreij[3];
+
+		vi[0] = parti.rdata(FHD_realData::velx);
+		vi[1] = parti.rdata(FHD_realData::vely);
+		vi[2] = parti.rdata(FHD_realData::velz);
+
+		vj[0] = partj.rdata(FHD_realData::velx);
+		vj[1] = partj.rdata(FHD_realData::vely);
+		vj[2] = partj.rdata(FHD_realData::velz);
+
+		vij[0] = vi[0]-vj[0]; vij[1] = vi[1]-vj[1]; vij[2] = vi[2]-vj[2];
+		Real vrmag = sqrt(vij[0]*vij[0]+vij[1]*vij[1]+vij[2]*vij[2]);
+		if(vrmag>vrmax) {vrmax = vrmag; arrvrmax(i,j,k,specij) = 1.1*vrmax;}
+
+		Real theta = 2.0*pi*rng.Random();
+		Real phi = std::acos(1.0-2.0*rng.Random());
+		eij[0] = std::sin(phi)*std::cos(theta);
+		eij[1] = std::sin(phi)*std::sin(theta);
+		eij[2] = std::cos(phi);
+		Real eijmag = sqrt(eij[0]*eij[0]+eij[1]*eij[1]+eij[2]*eij[2]);
+		for(int idim=0; idim<3; idim++)
+		{
+			eij[idim] /= eijmag;
+		}
+
+		Real vreijmag = vij[0]*eij[0]+vij[1]*eij[1]+vij[2]*eij[2];
+		if(vrmag>vrmax*rng.Random())
+		{
+			vreijmag = vreijmag*2.0/massij;
+			vreij[0] = vreijmag*eij[0];
+			vreij[1] = vreijmag*eij[1];
+			vreij[2] = vreijmag*eij[2];
+
+			parti.rdata(FHD_realData::velx) = vi[0] - vreij[0]*massj;
+			parti.rdata(FHD_realData::vely) = vi[1] - vreij[1]*massj;
+			parti.rdata(FHD_realData::velz) = vi[2] - vreij[2]*massj;
+			partj.rdata(FHD_realData::velx) = vj[0] + vreij[0]*massi;
+			partj.rdata(FHD_realData::vely) = vj[1] + vreij[1]*massi;
+			partj.rdata(FHD_realData::velz) = vj[2] + vreij[2]*massi;
+		}
 	}
 }
 
+int FhdParticleContainer::getSpeciesIndex(int species1, int species2)
+{
+	return DsmcSpeciesIndex(species1,species2,nspecies);
+}
+
 void FhdParticleContainer::InitCollisionCells()
 {
 	BL_PROFILE_VAR("InitCollisionCells()",InitCollisionCells);
@@ -63,46 +198,47 @@ void FhdParticleContainer::CalcSelections(Real dt)
 	BL_PROFILE_VAR("CalcSelections()",CalcSelections);
 	int lev = 0;
 	mfselect.setVal(0.0);
+
+	const Box& domain = Geom(lev).Domain();
+	const Long rngSeed = collideSeed;
+	const int rngStep = collideStep;
+	const int ns = nspecies;
+	const Real selFac = particle_neff*ocollisionCellVol*dt;
+
+	GpuArray<Real,MAX_SPECIES*MAX_SPECIES> csx;
+	for (int ij_spec = 0; ij_spec<ns*ns; ij_spec++)
+	{
+		csx[ij_spec] = interproperties[ij_spec].csx;
+	}
+
 	for(MFIter mfi(mfvrmax); mfi.isValid(); ++mfi)
 	{
 		const Box& tile_box  = mfi.tilebox();
 		const int grid_id = mfi.index();
-		const int tile_id = mfi.LocalTileIndex();
-		auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
-		auto& particles = particle_tile.GetArrayOfStructs();
+		const DsmcCellList cells = m_cell_index[grid_id].view();
 
-		const Array4<Real> & arrvrmax = mfvrmax.array(mfi);
+		const Array4<const Real> & arrvrmax = mfvrmax.const_array(mfi);
 		const Array4<Real> & arrselect = mfselect.array(mfi);
 
-		amrex::ParallelFor(tile_box,[=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-			int ij_spec;
-			long np_i, np_j;
-
-			const IntVect& iv = {i,j,k};
-			long imap = tile_box.index(iv);
+		DsmcForEachCell(tile_box, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+		{
+			const IntVect iv(i,j,k);
+			const Long imap = tile_box.index(iv);
 
-			Real vrmax;
-			Real NSel;
-			Real crossSection;
+			PhiloxStream rng = DsmcCellStream(rngSeed, rngStep, 0, domain.index(iv));
 
-			for (int i_spec = 0; i_spec<nspecies; i_spec++)
+			for (int i_spec = 0; i_spec<ns; i_spec++)
 			{
-				for (int j_spec = i_spec; j_spec < nspecies; j_spec++) {
-					ij_spec = getSpeciesIndex(i_spec,j_spec);
-					np_i = m_cell_vectors[i_spec][grid_id][imap].size();
-					np_j = m_cell_vectors[j_spec][grid_id][imap].size();
+				for (int j_spec = i_spec; j_spec < ns; j_spec++) {
+					int ij_spec = DsmcSpeciesIndex(i_spec,j_spec,ns);
+					long np_i = cells.numParticles(i_spec,imap);
+					long np_j = cells.numParticles(j_spec,imap);
 
-					vrmax = arrvrmax(i,j,k,ij_spec);
-					crossSection = interproperties[ij_spec].csx;
+					Real vrmax = arrvrmax(i,j,k,ij_spec);
 					if(i_spec==j_spec) {np_j = np_i-1;}
-					NSel = particle_neff*np_i*np_j*crossSection*vrmax*ocollisionCellVol*dt;
+					Real NSel = np_i*np_j*csx[ij_spec]*vrmax*selFac;
 					if(i_spec==j_spec) {NSel = NSel*0.5;}
-					arrselect(i,j,k,ij_spec) = std::floor(NSel + amrex::Random());
-					
-					if(i==1)
-					{
-					    //Print() << "spec " << i_spec << " and " << j_spec << " selecting " << arrselect(i,j,k,ij_spec) << endl;
-					}
+					arrselect(i,j,k,ij_spec) = std::floor(NSel + rng.Random());
 				}
 			}
 		});
@@ -113,226 +249,43 @@ void FhdParticleContainer::CollideParticles(Real dt)
 {
 	BL_PROFILE_VAR("CollideParticles()",CollideParticles);
 	int lev = 0;
+
+	const Box& domain = Geom(lev).Domain();
+	const Long rngSeed = collideSeed;
+	const int rngStep = collideStep;
+	const int ns = nspecies;
+	const Real pi = pi_usr;
+
+	GpuArray<Real,MAX_SPECIES> mass;
+	for (int i_spec = 0; i_spec<ns; i_spec++)
+	{
+		mass[i_spec] = properties[i_spec].mass;
+	}
+
 	for(MFIter mfi(mfvrmax); mfi.isValid(); ++mfi)
 	{
 		const Box& tile_box  = mfi.tilebox();
 		const int grid_id = mfi.index();
 		const int tile_id = mfi.LocalTileIndex();
+		const DsmcCellList cells = m_cell_index[grid_id].view();
 		auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
 		auto& particles = particle_tile.GetArrayOfStructs();
+		ParticleType* pstruct = particles().dataPtr();
 
 		const Array4<Real> & arrvrmax = mfvrmax.array(mfi);
-		const Array4<Real> & arrselect = mfselect.array(mfi);
-
-		//const long np = particles.numParticles();
-		//amrex::ParallelForRNG(tile_box,
-		//	[=] AMREX_GPU_DEVICE (int i, int j, int k, amrex::RandomEngine const& engine) noexcept {
-		IntVect smallEnd = tile_box.smallEnd();
-		IntVect bigEnd = tile_box.bigEnd();
-
-		for (int i = smallEnd[0]; i <= bigEnd[0]; i++) {
-		for (int j = smallEnd[1]; j <= bigEnd[1]; j++) {
-		for (int k = smallEnd[2]; k <= bigEnd[2]; k++) {
-	        int totalCol = 0;
-			const IntVect& iv = {i,j,k};
-			long imap = tile_box.index(iv);
-
-			Real NSel[nspecies*nspecies], totalSel, selrun;
-			int np[nspecies];
-			int pindxi, pindxj;
-			int ij_spec;
-			
-						
-			for(int kk=0;kk<4;kk++)
-			{
-			   // if(i==1)
-        		//{
-			        //NSel[kk] = 0;
-			    //}
-			}
-
-			RealVect eij, vreij;
-			RealVect vi, vj, vij;
-			RealVect vijpost, boost;
-			Real massi, massj, massij;
-			Real vrmag, vrmax, vreijmag;
-
-			totalSel = 0;
-//			for (int i_spec = nspecies-1; i_spec>=0; i_spec--)
-			for(int i_spec = 0; i_spec<nspecies; i_spec++)
-			{
-				np[i_spec] = m_cell_vectors[i_spec][grid_id][imap].size();
-				for (int j_spec = i_spec; j_spec < nspecies; j_spec++)
-				{
-//				int j_spec = i_spec;
-					ij_spec = getSpeciesIndex(i_spec,j_spec);
-					NSel[ij_spec] = (int)arrselect(i,j,k,ij_spec);
-					totalSel += NSel[ij_spec];
-					if(i==0)
-    			    {
-					    //Print() << "cell " << i << " ij " << ij_spec << ": " << NSel[ij_spec] << endl;
-				    }
-				    if(i==127)
-    			    {
-					    //Print() << "cell " << i << " ij " << ij_spec << ": " << NSel[ij_spec] << endl;
-				    }
-                }
-
-			}
-			if(i==1)
-		    {
-    			//Print() << "total: " << totalSel << endl;
-    	    }
-			
-            int totalSelect2 = totalSel;
-			int speci, specj, specij;
-			
-
-			while (totalSel>0)
-			{
-				Real RR = amrex::Random();
-				bool spec_select = false;
-				selrun = 0;
-				speci = -1; specj = -1; specij = -1;
-
-
-    			//for (int i_spec = nspecies-1; i_spec>=0; i_spec--)    			
-				for(int i_spec = 0; i_spec<nspecies; i_spec++)
-				{
-					for(int j_spec=i_spec;j_spec<nspecies;j_spec++)
-					{
-					//int j_spec = i_spec;
-						ij_spec = getSpeciesIndex(i_spec,j_spec);
-						selrun += NSel[ij_spec];
-						if(i==1 && totalSelect2 == totalSel)
-						{
-						    //Print() << "selrun: " <<  ij_spec << ": " << NSel[ij_spec] << endl;
-						}
-						if(selrun/totalSel>RR && !spec_select)
-						{
-							spec_select = true;
-							specij = ij_spec;
-							speci = i_spec; specj = j_spec;
-							
-							
-							NSel[ij_spec] -= 1;
-						}
-					}
-				}
-				
-								
-//				Real specTest;
-//				int ci=0, cj=0;
-//				Real currentMax = 0;
-//				//for (int i_spec = nspecies-1; i_spec>=0; i_spec--)
-//				for(int i_spec = 0; i_spec<nspecies; i_spec++)
-//				{
-//					for(int j_spec=i_spec;j_spec<nspecies;j_spec++)
-//					{
-//						ij_spec = getSpeciesIndex(i_spec,j_spec);
-//						specTest = (NSel[ij_spec]/totalSel)*amrex::Random();
-//						//Print() << "SpecTest: " << specTest << endl;
-//						if(specTest > currentMax){ci = i_spec;cj = j_spec; currentMax = specTest;}
-//					}
-//				}
-//				//Print() << "ci, cj: " << ci << ", " << cj << endl;
-//				specij = getSpeciesIndex(ci,cj);
-//				speci = ci; specj = cj;
-//				NSel[ij_spec]--;
-				
-				
-//				Real specTest;
-//				int breaktest = 0;
-//				int ci=0, cj=0;
-//				Real currentMax = 0;
-//				for (int i_spec = nspecies-1; i_spec>=0; i_spec--)
-//				//for(int i_spec = 0; i_spec<nspecies; i_spec++)
-//				{
-//					for(int j_spec=i_spec;j_spec<nspecies;j_spec++)
-//					{
-//						ij_spec = getSpeciesIndex(i_spec,j_spec);
-//						if(NSel[ij_spec] > 0 && breaktest == 0){ci = i_spec;cj = j_spec; breaktest = 1;}
-//					}
-//				}
-//				//Print() << "ci, cj: " << ci << ", " << cj << endl;
-//				specij = getSpeciesIndex(ci,cj);
-//				speci = ci; specj = cj;
-//				NSel[ij_spec]--;
-
-	
-				totalSel--;
-				massi = properties[speci].mass;
-				massj = properties[specj].mass;
-				massij = properties[speci].mass + properties[specj].mass;
-				vrmax = arrvrmax(i,j,k,specij);
-				pindxi = (int)floor(amrex::Random()*m_cell_vectors[speci][grid_id][imap].size());
-				pindxj = (int)floor(amrex::Random()*m_cell_vectors[specj][grid_id][imap].size());
-				pindxi = m_cell_vectors[speci][grid_id][imap][pindxi];
-				pindxj = m_cell_vectors[specj][grid_id][imap][pindxj];
-				
-				//if(i==1){Print() << "spec " << speci << " part " << pindxi << " of "  << m_cell_vectors[speci][grid_id][imap].size() << endl;}
-                //if(i==1){Print() << "spec " << specj << " part " << pindxj << " of "  << m_cell_vectors[specj][grid_id][imap].size() << endl;}
-				
-				ParticleType & parti = particles[pindxi];
-				ParticleType & partj = particles[pindxj];
+		const Array4<const Real> & arrselect = mfselect.const_array(mfi);
 
-				vi[0] = parti.rdata(FHD_realData::velx);
-				vi[1] = parti.rdata(FHD_realData::vely);
-				vi[2] = parti.rdata(FHD_realData::velz);
-				
-				vj[0] = partj.rdata(FHD_realData::velx);
-				vj[1] = partj.rdata(FHD_realData::vely);
-				vj[2] = partj.rdata(FHD_realData::velz);
-				
-				
-				//if(i==1){Print() << "vel1 " << vi[0] << " vel2 " << vj[0] << endl;}
-
-				vij[0] = vi[0]-vj[0]; vij[1] = vi[1]-vj[1]; vij[2] = vi[2]-vj[2];
-				vrmag = sqrt(pow(vij[0],2)+pow(vij[1],2)+pow(vij[2],2));
-				if(vrmag>vrmax) {vrmax = vrmag; arrvrmax(i,j,k,specij) = 1.1*vrmax;}
-
-				Real eijmag = 0;
-				Real theta = 2.0*pi_usr*amrex::Random();
-				Real phi = std::acos(1.0-2.0*amrex::Random());
-				eij[0] = std::sin(phi)*std::cos(theta);
-				eij[1] = std::sin(phi)*std::sin(theta);
-				eij[2] = std::cos(phi);
-				eijmag = pow(eij[0],2)+pow(eij[1],2)+pow(eij[2],2);
-				eijmag = pow(eijmag,0.5);
-				for(int idim=0; idim<3; idim++)
-				{
-					eij[idim] /= eijmag;
-				}
-
-				vreijmag = vij[0]*eij[0]+vij[1]*eij[1]+vij[2]*eij[2];
-				if(vrmag>vrmax*amrex::Random())
-				{
-					vreijmag = vreijmag*2.0/massij;
-					vreij[0] = vreijmag*eij[0];
-					vreij[1] = vreijmag*eij[1];
-					vreij[2] = vreijmag*eij[2];
+		DsmcForEachCell(tile_box, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+		{
+			const IntVect iv(i,j,k);
+			PhiloxStream rng = DsmcCellStream(rngSeed, rngStep, 1, domain.index(iv));
 
-					parti.rdata(FHD_realData::velx) = vi[0] - vreij[0]*massj;
-					parti.rdata(FHD_realData::vely) = vi[1] - vreij[1]*massj;
-					parti.rdata(FHD_realData::velz) = vi[2] - vreij[2]*massj;
-					partj.rdata(FHD_realData::velx) = vj[0] + vreij[0]*massi;
-					partj.rdata(FHD_realData::vely) = vj[1] + vreij[1]*massi;
-					partj.rdata(FHD_realData::velz) = vj[2] + vreij[2]*massi;
-					totalCol++;
-				}
-			}
-			for(int kk=0;kk<4;kk++)
-			{
-			    if(i==1)
-        		{
-			        //Print() << "post ij2 " << kk << ": " << NSel[kk] << endl;
-			    }
-			}
-			//Print() << "total cols: " << totalCol << "\n";
-		}
-		}
-		}
+			DsmcCollideCell(i, j, k, tile_box.index(iv), cells, pstruct,
+			                arrselect, arrvrmax, mass, ns, pi, rng);
+		});
 	}
+
+	collideStep++;
 }
 
 void FhdParticleContainer::CollideParticles2(Real dt)
@@ -343,6 +296,7 @@ void FhdParticleContainer::CollideParticles2(Real dt)
 	{
 		const Box& tile_box  = mfi.tilebox();
 		const int grid_id = mfi.index();
+		const DsmcCellList cells = m_cell_index[grid_id].view();
 		const int tile_id = mfi.LocalTileIndex();
 		auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
 		auto& particles = particle_tile.GetArrayOfStructs();
@@ -375,8 +329,8 @@ void FhdParticleContainer::CollideParticles2(Real dt)
 			    for(int j_spec = 0; j_spec<nspecies; j_spec++)
 			    {   
                    int ij_index = getSpeciesIndex(i_spec,j_spec);
-                   int np_i = m_cell_vectors[i_spec][grid_id][imap].size();
-                   int np_j = m_cell_vectors[j_spec][grid_id][imap].size();
+                   int np_i = cells.numParticles(i_spec,imap);
+                   int np_j = cells.numParticles(j_spec,imap);
                    if(i_spec == j_spec){np_i--;}
                    Real select = np_i*np_j*interproperties[ij_index].csx*particle_neff*arrvrmax(i,j,k,ij_index)*ocollisionCellVol*dt;
                    if(i_spec != j_spec){select = select*0.5;}
@@ -433,10 +387,10 @@ void FhdParticleContainer::CollideParticles2(Real dt)
 				Real massj = properties[specj].mass;
 				Real massij = properties[speci].mass + properties[specj].mass;
 				//vrmax = arrvrmax(i,j,k,specij);
-				int pindxi = (int)floor(amrex::Random()*m_cell_vectors[speci][grid_id][imap].size());
-				int pindxj = (int)floor(amrex::Random()*m_cell_vectors[specj][grid_id][imap].size());
-				pindxi = m_cell_vectors[speci][grid_id][imap][pindxi];
-				pindxj = m_cell_vectors[specj][grid_id][imap][pindxj];
+				int pindxi = (int)floor(amrex::Random()*cells.numParticles(speci,imap));
+				int pindxj = (int)floor(amrex::Random()*cells.numParticles(specj,imap));
+				pindxi = cells.particles(speci,imap)[pindxi];
+				pindxj = cells.particles(specj,imap)[pindxj];
 				
 				ParticleType & parti = particles[pindxi];
 				ParticleType & partj = particles[pindxj];
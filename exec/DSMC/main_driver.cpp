@@ -8,6 +8,7 @@
 #include "iostream"
 #include "fstream"
 #include "DsmcParticleContainer.H"
+#include "dsmc_functions.H"
 #include <AMReX_MultiFab.H>
 #include <AMReX_PlotFileUtil.H>
 
@@ -21,6 +22,7 @@ void main_driver(const char* argv)
 	std::string inputs_file = argv;
 
 	InitializeCommonNamespace();
+	InitializeDsmcNamespace();
 
 	BoxArray ba;
 	IntVect dom_lo(AMREX_D_DECL(           0,            0,            0));
@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Thread scaling of the DSMC selection and collision kernels
+# Cells are processed concurrently with per-cell random streams, so for a
+# fixed seed the results do not depend on the number of threads.
+# Requires an executable built with USE_OMP=TRUE and TINY_PROFILE=TRUE; the
+# times are the inclusive times reported by TinyProfiler.
+
+nprocs="1"
+dim="3"
+make -j8 DIM=${dim} USE_OMP=TRUE TINY_PROFILE=TRUE
+
+executable=$(ls -t main${dim}d*.ex | head -1)
+
+Inputs=("test_inputs/input_periodic_eq" "test_inputs/inputs_conc")
+Threads=("1" "2" "4" "8" "16")
+nsteps="200"
+
+output_dir="Data_Collide_Benchmark"
+mkdir -p "${output_dir}"
+
+summary="${output_dir}/summary.txt"
+echo "inputs threads ncalls CollideParticles()_incl_avg CalcSelections()_incl_avg" > ${summary}
+
+for input_file in "${Inputs[@]}"
+do
+    for nthreads in "${Threads[@]}"
+    do
+        out="${output_dir}/$(basename ${input_file})_omp${nthreads}.out"
+
+        OMP_NUM_THREADS=${nthreads} mpiexec -n ${nprocs} ./${executable} ${input_file} \
+                       seed=1 max_step=${nsteps} plot_int=-1 chk_int=-1 n_steps_skip=${nsteps} > ${out}
+
+        # the inclusive-time table is the second one printed by TinyProfiler
+        collide=$(grep "CollideParticles()" ${out} | tail -1 | awk '{print $2, $4}')
+        select=$(grep "CalcSelections()" ${out} | tail -1 | awk '{print $4}')
+
+        echo "$(basename ${input_file}) ${nthreads} ${collide} ${select}" >> ${summary}
+    done
+done
+
+column -t ${summary}
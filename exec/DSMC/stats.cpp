@@ -35,6 +35,7 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
         
     for (FhdParIter pti(* this, lev); pti.isValid(); ++pti) {
         const int grid_id = pti.index();
+        const DsmcCellList cells = m_cell_index[grid_id].view();
         const int tile_id = pti.LocalTileIndex();
         const Box& tile_box  = pti.tilebox();
                 
@@ -108,7 +109,7 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
 
 
             for (int l=0; l<nspecies; l++) {
-                long np_spec = m_cell_vectors[l][grid_id][imap].size();
+                long np_spec = cells.numParticles(l,imap);
                 //long np_spec = cell_vecs[l][grid_id][imap].size();
                 //const long np_spec = 1;
                 Real mass = propertiesPtr[l].mass*propertiesPtr[l].Neff;
@@ -127,7 +128,7 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
 
                 // Read particle data
                 for (int m=0; m<np_spec; m++) {
-                    int pind = m_cell_vectors[l][grid_id][imap][m];
+                    int pind = cells.particles(l,imap)[m];
                     //int pind = 1;
                     ParticleType & p = particles[pind];
                     Real u = p.rdata(FHD_realData::velx);
@@ -208,10 +209,10 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
             int specTotal = 0;
             
             for (int l=nspecies-1; l>=0; l--) {
-                long np_spec = m_cell_vectors[l][grid_id][imap].size();
+                long np_spec = cells.numParticles(l,imap);
                 
                 for (int m=0; m<np_spec; m++) {
-                    int pind = m_cell_vectors[l][grid_id][imap][m];
+                    int pind = cells.particles(l,imap)[m];
                     //int pind = 1;
                     ParticleType & p = particles[pind];
                     
@@ -231,10 +232,10 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
             primInst(i,j,k,6) = 0;
             
             for (int l=nspecies-1; l>=0; l--) {
-                long np_spec = m_cell_vectors[l][grid_id][imap].size();
+                long np_spec = cells.numParticles(l,imap);
                 
                 for (int m=0; m<np_spec; m++) {
-                    int pind = m_cell_vectors[l][grid_id][imap][m];
+                    int pind = cells.particles(l,imap)[m];
                     //int pind = 1;
                     ParticleType & p = particles[pind];
                     
@@ -372,10 +373,10 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
             Real tTemp = 0;
             int specTotal = 0;
             for (int l=nspecies-1; l>=0; l--) {
-                long np_spec = m_cell_vectors[l][grid_id][imap].size();
+                long np_spec = cells.numParticles(l,imap);
                 
                 for (int m=0; m<np_spec; m++) {
-                    int pind = m_cell_vectors[l][grid_id][imap][m];
+                    int pind = cells.particles(l,imap)[m];
                     //int pind = 1;
                     ParticleType & p = particles[pind];
                     
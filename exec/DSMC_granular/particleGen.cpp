@@ -172,6 +172,7 @@ void FhdParticleContainer::InitParticles(Real & dt)
 	for (FhdParIter pti(* this, lev); pti.isValid(); ++pti)
 	{
 		const int grid_id = pti.index();
+		const DsmcCellList cells = m_cell_index[grid_id].view();
 		const int tile_id = pti.LocalTileIndex();
 		const Box& tile_box  = pti.tilebox();
 
@@ -190,10 +191,10 @@ void FhdParticleContainer::InitParticles(Real & dt)
 			for (int niter=0; niter<3; niter++) {
 			for (int ispec=0; ispec<nspecies; ispec++){
 				Real ucom=0., vcom=0., wcom=0.;
-				int np = m_cell_vectors[ispec][grid_id][imap].size();
+				int np = cells.numParticles(ispec,imap);
 				double lmass = properties[ispec].mass;
 				for (int ip = 0; ip<np; ip++) {
-					int ipart = m_cell_vectors[ispec][grid_id][imap][ip];
+					int ipart = cells.particles(ispec,imap)[ip];
 					ParticleType & part = particles[ipart];
 					ucom += part.rdata(FHD_realData::velx);
 					vcom += part.rdata(FHD_realData::vely);
@@ -204,7 +205,7 @@ void FhdParticleContainer::InitParticles(Real & dt)
 				wcom /= (double)np;
 				for (int ip = 0; ip<np; ip++)
 				{
-					int ipart = m_cell_vectors[ispec][grid_id][imap][ip];
+					int ipart = cells.particles(ispec,imap)[ip];
 					ParticleType & part = particles[ipart];
 					part.rdata(FHD_realData::velx) = part.rdata(FHD_realData::velx) - ucom;
 					part.rdata(FHD_realData::vely) = part.rdata(FHD_realData::vely) - vcom;
@@ -31,6 +31,7 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
     const int lev = 0;    
     for (FhdParIter pti(* this, lev); pti.isValid(); ++pti) {
         const int grid_id = pti.index();
+        const DsmcCellList cells = m_cell_index[grid_id].view();
         const int tile_id = pti.LocalTileIndex();
         const Box& tile_box  = pti.tilebox();
         auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
@@ -86,7 +87,7 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
             cvlInst(i,j,k,0) = 0;
 
             for (int l=0; l<nspecies; l++) {
-                const long np_spec = m_cell_vectors[l][grid_id][imap].size();
+                const long np_spec = cells.numParticles(l,imap);
                 Real mass = properties[l].mass*properties[l].Neff;
                 Real moV  = properties[l].mass*ocollisionCellVol;
                 primInst(i,j,k,iprim+0) = np_spec*ocollisionCellVol;
@@ -101,7 +102,7 @@ void FhdParticleContainer::EvaluateStats(MultiFab& mfcuInst,
 
                 // Read particle data
                 for (int m=0; m<np_spec; m++) {
-                    int pind = m_cell_vectors[l][grid_id][imap][m];
+                    int pind = cells.particles(l,imap)[m];
                     ParticleType ptemp = particles[pind];
                     ParticleType & p = ptemp;
                     // ParticleType & p = particles[pind];
@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# Compare the two calculateFlux paths on the profiling inputs
+#   fused_flux = 0: each flux stage sweeps over all boxes
+#   fused_flux = 1: all flux stages are computed tile by tile
+# Requires an executable built with TINY_PROFILE=TRUE; the flux time is the
+# inclusive time of calculateFlux() reported by TinyProfiler.
+
+nprocs="4"
+dim="3"
+make -j${nprocs} DIM=${dim} TINY_PROFILE=TRUE
+
+executable=$(ls -t main${dim}d*.ex | head -1)
+
+Inputs=("inputs_profiling_gpu")
+Fused=("0" "1")
+
+output_dir="Data_Flux_Benchmark"
+mkdir -p "${output_dir}"
+
+summary="${output_dir}/summary.txt"
+echo "inputs fused_flux ncalls calculateFlux()_incl_avg" > ${summary}
+
+for input_file in "${Inputs[@]}"
+do
+    for fused in "${Fused[@]}"
+    do
+        out="${output_dir}/${input_file}_fused${fused}.out"
+
+        mpiexec -n ${nprocs} ./${executable} ${input_file} \
+                fused_flux=${fused} plot_int=-1 > ${out}
+
+        # the inclusive-time table is the second one printed by TinyProfiler
+        flux=$(grep "calculateFlux()" ${out} | tail -1 | awk '{print $2, $4}')
+
+        echo "${input_file} ${fused} ${flux}" >> ${summary}
+    done
+done
+
+column -t ${summary}
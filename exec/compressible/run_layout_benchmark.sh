@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# Compare the component-major and cell-major (USE_CELL_MAJOR_STATE=TRUE) state
+# layouts in the compressible flux kernels on the 3D regression inputs.
+# The flux time is the inclusive time of calculateFlux() reported by
+# TinyProfiler; cache misses are taken from "perf stat" when it is available.
+# Both layouts share object files, so the executable is rebuilt from scratch
+# for each layout.
+
+nprocs="4"
+dim="3"
+
+Inputs=("inputs_regression_equil_3d" "inputs_regression_RT_3d")
+Layout=("FALSE" "TRUE")
+
+output_dir="Data_Layout_Benchmark"
+mkdir -p "${output_dir}"
+
+summary="${output_dir}/summary.txt"
+echo "inputs cell_major ncalls calculateFlux()_incl_avg cache-misses" > ${summary}
+
+if command -v perf > /dev/null; then
+    perf_cmd="perf stat -e cache-misses,cache-references -x ,"
+else
+    perf_cmd=""
+fi
+
+for layout in "${Layout[@]}"
+do
+    make realclean > /dev/null
+    make -j${nprocs} DIM=${dim} TINY_PROFILE=TRUE USE_CELL_MAJOR_STATE=${layout}
+
+    executable=$(ls -t main${dim}d*.ex | head -1)
+
+    for input_file in "${Inputs[@]}"
+    do
+        out="${output_dir}/${input_file}_cellmajor${layout}.out"
+        perf_out="${output_dir}/${input_file}_cellmajor${layout}.perf"
+
+        ${perf_cmd:+${perf_cmd} -o ${perf_out}} mpiexec -n ${nprocs} ./${executable} ${input_file} \
+                plot_int=-1 > ${out}
+
+        # the inclusive-time table is the second one printed by TinyProfiler
+        flux=$(grep "calculateFlux()" ${out} | tail -1 | awk '{print $2, $4}')
+
+        misses="n/a"
+        if [ -f ${perf_out} ]; then
+            misses=$(grep "cache-misses" ${perf_out} | cut -d, -f1)
+        fi
+
+        echo "${input_file} ${layout} ${flux} ${misses}" >> ${summary}
+    done
+done
+
+column -t ${summary}
@@ -1,6 +1,7 @@
 #include "common_functions.H"
 #include "compressible_functions.H"
 #include "compressible_functions_stag.H"
+#include "RK3IntegratorStag.H"
 
 #include <AMReX_Vector.H>
 
@@ -903,6 +904,9 @@ void main_driver(const char* argv)
                  cenflux[1].define(ba,dmap,1,1);,
                  cenflux[2].define(ba,dmap,1,1););
                 
+    // integrator owns the stage states and white noise work fields for the whole run
+    RK3IntegratorStag integrator(ba, dmap);
+
     /////////////////////////////////////////////////
     //Time stepping loop
     /////////////////////////////////////////////////
@@ -916,8 +920,8 @@ void main_driver(const char* argv)
         if (ads_spec>=0) sample_MFsurfchem(cu, prim, surfcov, dNadsdes, dx, dt);
 
         // FHD
-        RK3stepStag(cu, cumom, prim, vel, source, eta, zeta, kappa, chi, D, 
-            faceflux, edgeflux_x, edgeflux_y, edgeflux_z, cenflux, geom, dt, step);
+        integrator.Step(cu, cumom, prim, vel, source, eta, zeta, kappa, chi, D, 
+                        faceflux, edgeflux_x, edgeflux_y, edgeflux_z, cenflux, geom, dt, step);
 
         // update surface chemistry
         if (ads_spec>=0) {
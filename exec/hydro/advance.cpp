@@ -20,7 +20,8 @@ void advance(std::array< MultiFab, AMREX_SPACEDIM >& umac,
              MultiFab& beta, MultiFab& gamma,
              std::array< MultiFab, NUM_EDGE >& beta_ed,
              const Geometry& geom, const Real& dt,
-             TurbForcing& turbforce)
+             TurbForcing& turbforce,
+             GMRES& gmres)
 {
 
   BL_PROFILE_VAR("advance()",advance);
@@ -131,7 +132,6 @@ void advance(std::array< MultiFab, AMREX_SPACEDIM >& umac,
   Real gmres_abs_tol_in = gmres_abs_tol; // save this
 
   // call GMRES to compute predictor
-  GMRES gmres(ba,dmap,geom);
   gmres.Solve(gmres_rhs_u,gmres_rhs_p,umacNew,pres,
               alpha_fc,beta,beta_ed,gamma,
               theta_alpha,geom,norm_pre_rhs);
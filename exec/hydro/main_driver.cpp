@@ -533,6 +533,10 @@ void main_driver(const char* argv)
 
     ///////////////////////////////////////////
 
+    // build the GMRES solver (Krylov vectors and multigrid hierarchies) once
+    // and reuse it every time step
+    GMRES gmres(ba,dmap,geom);
+
     //Time stepping loop
     for(int step=step_start;step<=max_step;++step) {
 
@@ -549,7 +553,7 @@ void main_driver(const char* argv)
 
 	// Advance umac
         advance(umac,umacTemp,pres,mfluxdiv_stoch,
-                alpha_fc,beta,gamma,beta_ed,geom,dt,turbforce);
+                alpha_fc,beta,gamma,beta_ed,geom,dt,turbforce,gmres);
 
 	//////////////////////////////////////////////////
 
@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# Compare the V-cycle time of the staggered multigrid solver on the profiling inputs
+#   baseline: the tree at the given revision (the one before the smoother changes),
+#             built in a temporary git worktree, with stag_mg_smoother = 1
+#   current : this tree with
+#     stag_mg_smoother = 1: red-black Gauss-Seidel, one face direction per color
+#     stag_mg_smoother = 2: red-black Gauss-Seidel, all face directions per color
+#                           (one packed ghost cell exchange per color)
+# Both executables are built with TINY_PROFILE=TRUE; the V-cycle time is the
+# inclusive time of StagMGSolver::Solve() reported by TinyProfiler.
+#
+# usage: ./run_smoother_benchmark.sh <baseline revision>
+
+if [ $# -ne 1 ]; then
+    echo "usage: $0 <baseline revision>"
+    exit 1
+fi
+baseline_rev=$1
+
+nprocs="4"
+dim="3"
+
+export AMREX_HOME=${AMREX_HOME:-$(cd ../../../amrex && pwd)}
+
+output_dir="Data_Smoother_Benchmark"
+mkdir -p "${output_dir}"
+output_dir=$(cd ${output_dir} && pwd)
+
+# baseline build
+worktree="${output_dir}/baseline_src"
+git worktree add --detach ${worktree} ${baseline_rev} || exit 1
+(cd ${worktree}/exec/hydro && make -j${nprocs} DIM=${dim} TINY_PROFILE=TRUE) || exit 1
+baseline_exe=$(ls -t ${worktree}/exec/hydro/main${dim}d*.ex | head -1)
+
+# current build
+make -j${nprocs} DIM=${dim} TINY_PROFILE=TRUE || exit 1
+current_exe=$(pwd)/$(ls -t main${dim}d*.ex | head -1)
+
+Inputs=("inputs_profiling_discos_3d" "inputs_profiling_rtil_3d")
+Runs=("baseline:1" "current:1" "current:2")
+
+summary="${output_dir}/summary.txt"
+echo "inputs build smoother ncalls StagMGSolver::Solve()_incl_avg StagMGFillBoundary()_incl_avg" > ${summary}
+
+for input_file in "${Inputs[@]}"
+do
+    for run in "${Runs[@]}"
+    do
+        build=${run%%:*}
+        smoother=${run##*:}
+
+        if [ ${build} == "baseline" ]; then
+            exe=${baseline_exe}
+        else
+            exe=${current_exe}
+        fi
+
+        out="${output_dir}/${input_file}_${build}_smoother${smoother}.out"
+
+        mpiexec -n ${nprocs} ${exe} ${input_file} \
+                stag_mg_smoother=${smoother} plot_int=-1 > ${out}
+
+        # the inclusive-time table is the second one printed by TinyProfiler
+        solve=$(grep -F "StagMGSolver::Solve()" ${out} | tail -1 | awk '{print $2, $4}')
+        fill=$(grep -F "StagMGFillBoundary()" ${out} | tail -1 | awk '{print $4}')
+
+        echo "${input_file} ${build} ${smoother} ${solve:-n/a n/a} ${fill:-n/a}" >> ${summary}
+    done
+done
+
+git worktree remove --force ${worktree}
+
+column -t ${summary}
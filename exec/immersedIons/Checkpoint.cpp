@@ -288,6 +288,10 @@ void ReadCheckPoint(int& step,
         else if (*(std::max_element(eskernel_fluid.begin(),eskernel_fluid.begin()+nspecies)) > 0) {
             ngp = static_cast<int>(floor(*(std::max_element(eskernel_fluid.begin(),eskernel_fluid.begin()+nspecies)))/2+1);
         }
+        // PPPM mode: B-spline assignment of order p3m_order spans p3m_order+1 cells
+        if (es_tog==3 && p3m_alpha > 0) {
+            ngp = (p3m_order+1)/2;
+        }
 
         chargeM.define(bp,dm,1,1);
         potential.define(bp,dm,1,ngp);
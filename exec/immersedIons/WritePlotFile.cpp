@@ -185,8 +185,14 @@ void WritePlotFile(int step,
 
     // particle in cplt file
 
-    Vector<int> write_real_comp(FHD_realData::count);
+    // particle struct components, then the struct-of-arrays ones
+    Vector<int> write_real_comp(FHD_realData::count + FHD_soaData::count);
     fill(write_real_comp.begin(), write_real_comp.end(), 1);
+
+    Vector<std::string> real_comp_names = FHD_realData::names();
+    for (const auto& name : FHD_soaData::names()) {
+        real_comp_names.push_back(name);
+    }
     
     Vector<int> write_int_comp(FHD_intData::count);
     fill(write_int_comp.begin(), write_int_comp.end(), 1);
@@ -194,7 +200,7 @@ void WritePlotFile(int step,
     t1 = ParallelDescriptor::second();
     
     particles.WritePlotFile(cplotfilename, "particles",
-                            write_real_comp, write_int_comp, FHD_realData::names(), FHD_intData::names());
+                            write_real_comp, write_int_comp, real_comp_names, FHD_intData::names());
     
     t2 = ParallelDescriptor::second() - t1;
     ParallelDescriptor::ReduceRealMax(t2);
@@ -107,6 +107,10 @@ void main_driver(const char* argv)
     else if (*(std::max_element(pkernel_es.begin(),pkernel_es.begin()+nspecies)) == 6) {
         ngp = 4;
     } 
+    // PPPM mode: B-spline assignment of order p3m_order spans p3m_order+1 cells
+    if (es_tog==3 && p3m_alpha > 0) {
+        ngp = (p3m_order+1)/2;
+    }
 
     // staggered velocities
     // umac needs extra ghost cells for Peskin kernels
@@ -756,6 +760,18 @@ void main_driver(const char* argv)
         }
     }
 
+    // cutoff pairwise Coulomb forces use the same neighbor list
+    if(es_tog==2 && coulomb_cutoff > max_es_range)
+    {
+        max_es_range = coulomb_cutoff;
+    }
+
+    // as does the real-space part of the PPPM mode
+    if(es_tog==3 && p3m_alpha > 0)
+    {
+        max_es_range = p3m_cutoff;
+    }
+
     for(int i=0;i<(nspecies*nspecies);i++) {
         Real range = sigma[i]*rmax[i];
 
@@ -811,6 +827,15 @@ void main_driver(const char* argv)
 
     FindCenterCoords(RealCenteredCoords, geomP);
 
+    // PPPM mode: a priori force error for this mesh, order and cutoff
+    if (es_tog==3 && p3m_alpha > 0) {
+        Real sum_q2 = 0;
+        for(int i=0;i<nspecies;i++) {
+            sum_q2 += ionParticle[i].total*ionParticle[i].q*ionParticle[i].q;
+        }
+        esP3MErrorEstimate(geomP, sum_q2, simParticles);
+    }
+
     //charage density for RHS of Poisson Eq.
     MultiFab charge(bp, dmap, 1, ngp);
     charge.setVal(0);
@@ -1298,10 +1323,11 @@ void main_driver(const char* argv)
         // es_tog is electrostatic solve (0=off, 1=Poisson, 2=Pairwise, 3=P3M)
 	
 
-        if (sr_tog != 0 || es_tog==3) {
+        if (sr_tog != 0 || es_tog==3 || (es_tog==2 && coulomb_cutoff > 0)) {
 
             // compute short range forces (if sr_tog=1)
-            // compute P3M short range correction (if es_tog=3)
+            // compute P3M short range correction (if es_tog=3), or the real-space part in PPPM mode (p3m_alpha>0)
+            // compute cutoff pairwise Coulomb force (if es_tog=2 and coulomb_cutoff>0)
             particles.computeForcesNLGPU(charge, RealCenteredCoords, dxp);
         }
 
@@ -1314,7 +1340,7 @@ void main_driver(const char* argv)
         // Then calculate gradient and put in 'efieldCC', then add 'external'.
         esSolve(potential, charge, efieldCC, external, geomP);
 
-        if (es_tog==2) {
+        if (es_tog==2 && coulomb_cutoff <= 0) {
             // compute pairwise Coulomb force (currently hard-coded to work with y-wall).
 	    particles.computeForcesCoulombGPU(simParticles);
 	}
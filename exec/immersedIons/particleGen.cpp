@@ -4,6 +4,7 @@
 #include <sstream>
 #include <string>
 #include <fstream>
+#include <array>
 
 void FhdParticleContainer::InitParticles(species* particleInfo, const Real* dxp)
 {
@@ -64,8 +65,6 @@ void FhdParticleContainer::InitParticles(species* particleInfo, const Real* dxp)
 
                     }
 
-                    p.rdata(FHD_realData::spring) = 0;
-
                     p.idata(FHD_intData::visible) = 1;
 
                     p.rdata(FHD_realData::q) = particleInfo[i_spec].q;
@@ -73,17 +72,6 @@ void FhdParticleContainer::InitParticles(species* particleInfo, const Real* dxp)
  //                    std::cout << "proc " << ParallelDescriptor::MyProc() << " Pos: " << p.pos(0) << ", " << p.pos(1) << ", " << p.pos(2)
  //                              << ", " << p.rdata(FHD_realData::q) << ", " << p.id() << "\n" ;
 
-                    //original position stored for MSD calculations
-                    p.rdata(FHD_realData::ox) = p.pos(0);
-                    p.rdata(FHD_realData::oy) = p.pos(1);
-#if (BL_SPACEDIM == 3)
-                    p.rdata(FHD_realData::oz) = p.pos(2);
-#endif
-
-                    //p.rdata(FHD_realData::vx) = sqrt(particleInfo.R*particleInfo.T)*get_particle_normal_func();
-                    //p.rdata(FHD_realData::vy) = sqrt(particleInfo.R*particleInfo.T)*get_particle_normal_func();
-                    //p.rdata(FHD_realData::vz) = sqrt(particleInfo.R*particleInfo.T)*get_particle_normal_func();
-
                     p.rdata(FHD_realData::pred_posx) = 0;
                     p.rdata(FHD_realData::pred_posy) = 0;
                     p.rdata(FHD_realData::pred_posz) = 0;
@@ -96,47 +84,17 @@ void FhdParticleContainer::InitParticles(species* particleInfo, const Real* dxp)
                     p.rdata(FHD_realData::pred_forcey) = 0;
                     p.rdata(FHD_realData::pred_forcez) = 0;
 
-                    p.rdata(FHD_realData::fx) = 0;
-                    p.rdata(FHD_realData::fy) = 0;
-                    p.rdata(FHD_realData::fz) = 0;
-
-                    p.rdata(FHD_realData::vx) = 0;
-                    p.rdata(FHD_realData::vy) = 0;
-                    p.rdata(FHD_realData::vz) = 0;
-
-                    p.rdata(FHD_realData::ux) = 0;
-                    p.rdata(FHD_realData::uy) = 0;
-                    p.rdata(FHD_realData::uz) = 0;
-
                     p.rdata(FHD_realData::ax) = 0;
                     p.rdata(FHD_realData::ay) = 0;
                     p.rdata(FHD_realData::az) = 0;
 
-                    p.rdata(FHD_realData::fx) = 0;
-                    p.rdata(FHD_realData::fy) = 0;
-                    p.rdata(FHD_realData::fz) = 0;
-
-                    p.rdata(FHD_realData::travelTime) = 0;
-                    p.rdata(FHD_realData::diffAv) = 0;
-                    p.rdata(FHD_realData::stepCount) = 0;
-
                     p.rdata(FHD_realData::mass) = particleInfo[i_spec].m; //mass
                     p.rdata(FHD_realData::R) = particleInfo[i_spec].R; //R
                     p.rdata(FHD_realData::radius) = particleInfo[i_spec].d/2.0; //radius
-                    p.rdata(FHD_realData::accelFactor) = -6*3.14159265359*p.rdata(FHD_realData::radius)/p.rdata(FHD_realData::mass); //acceleration factor (replace with amrex c++ constant for pi...)
-                    p.rdata(FHD_realData::dragFactor) = 6*3.14159265359*p.rdata(FHD_realData::radius); //drag factor
-                    //p.rdata(FHD_realData::dragFactor) = 0; //drag factor
-                    //p.rdata(FHD_realData::dragFactor) = 6*3.14159265359*dx[0]*1.322; //drag factor
-
-                    p.rdata(FHD_realData::wetDiff) = particleInfo[i_spec].wetDiff;
-                    p.rdata(FHD_realData::dryDiff) = particleInfo[i_spec].dryDiff;
-                    p.rdata(FHD_realData::totalDiff) = particleInfo[i_spec].totalDiff;
 
                     p.rdata(FHD_realData::sigma) = particleInfo[i_spec].sigma;
-                    p.rdata(FHD_realData::eepsilon) = particleInfo[i_spec].eepsilon;
 
                     p.idata(FHD_intData::species) = i_spec +1;
-                    p.rdata(FHD_realData::potential) = 0;                 
 
                     // set distance for which we do direct, short range coulomb force calculation
                     // in p3m to be 6.5*dx_poisson_grid
@@ -145,6 +103,30 @@ void FhdParticleContainer::InitParticles(species* particleInfo, const Real* dxp)
 
                     particle_tile.push_back(p);
 
+                    // struct-of-arrays data, all other components start at zero
+                    std::array<Real, FHD_soaData::count> soa;
+                    soa.fill(0.);
+
+                    //original position stored for MSD calculations
+                    soa[FHD_soaData::ox] = p.pos(0);
+                    soa[FHD_soaData::oy] = p.pos(1);
+#if (BL_SPACEDIM == 3)
+                    soa[FHD_soaData::oz] = p.pos(2);
+#endif
+
+                    soa[FHD_soaData::accelFactor] = -6*3.14159265359*p.rdata(FHD_realData::radius)/p.rdata(FHD_realData::mass); //acceleration factor (replace with amrex c++ constant for pi...)
+                    soa[FHD_soaData::dragFactor] = 6*3.14159265359*p.rdata(FHD_realData::radius); //drag factor
+
+                    soa[FHD_soaData::wetDiff] = particleInfo[i_spec].wetDiff;
+                    soa[FHD_soaData::dryDiff] = particleInfo[i_spec].dryDiff;
+                    soa[FHD_soaData::totalDiff] = particleInfo[i_spec].totalDiff;
+
+                    soa[FHD_soaData::eepsilon] = particleInfo[i_spec].eepsilon;
+
+                    for (int comp=0; comp<FHD_soaData::count; ++comp) {
+                        particle_tile.push_back_real(comp, soa[comp]);
+                    }
+
                     pcount++;
                 }
             }
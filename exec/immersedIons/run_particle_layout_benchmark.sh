@@ -0,0 +1,73 @@
+#!/bin/bash
+
+# Compare the particle kernels before and after moving the cold per-particle
+# fields (FHD_soaData) out of the particle struct
+#   baseline: the tree at the given revision (the commit before FHD_soaData
+#             was introduced), built in a temporary git worktree
+#   current : this tree
+# Both executables are built with TINY_PROFILE=TRUE and run on the same inputs;
+# the times are the inclusive averages reported by TinyProfiler.
+#
+# usage: ./run_particle_layout_benchmark.sh <baseline revision>
+
+if [ $# -ne 1 ]; then
+    echo "usage: $0 <baseline revision>"
+    exit 1
+fi
+baseline_rev=$1
+
+nprocs="4"
+dim="3"
+
+export AMREX_HOME=${AMREX_HOME:-$(cd ../../../amrex && pwd)}
+
+output_dir="Data_Layout_Benchmark"
+mkdir -p "${output_dir}"
+output_dir=$(cd ${output_dir} && pwd)
+
+# baseline build
+worktree="${output_dir}/baseline_src"
+git worktree add --detach ${worktree} ${baseline_rev} || exit 1
+(cd ${worktree}/exec/immersedIons && make -j${nprocs} DIM=${dim} TINY_PROFILE=TRUE) || exit 1
+baseline_exe=$(ls -t ${worktree}/exec/immersedIons/main${dim}d*.ex | head -1)
+
+# current build
+make -j${nprocs} DIM=${dim} TINY_PROFILE=TRUE || exit 1
+current_exe=$(pwd)/$(ls -t main${dim}d*.ex | head -1)
+
+Inputs=("inputs_template")
+Timers=("MoveIons()" "computeForcesNL()" "SpreadIons()" "collectFields()")
+
+summary="${output_dir}/summary.txt"
+echo "inputs build ${Timers[*]}" > ${summary}
+
+for input_file in "${Inputs[@]}"
+do
+    for build in baseline current
+    do
+        if [ ${build} == "baseline" ]; then
+            exe=${baseline_exe}
+        else
+            exe=${current_exe}
+        fi
+
+        out="${output_dir}/${input_file}_${build}.out"
+
+        mpiexec -n ${nprocs} ${exe} ${input_file} \
+                plot_int=-1 chk_int=-1 > ${out}
+
+        # the inclusive-time table is the second one printed by TinyProfiler
+        line="${input_file} ${build}"
+        for timer in "${Timers[@]}"
+        do
+            t=$(grep -F "${timer}" ${out} | tail -1 | awk '{print $4}')
+            line="${line} ${t:-n/a}"
+        done
+
+        echo "${line}" >> ${summary}
+    done
+done
+
+git worktree remove --force ${worktree}
+
+column -t ${summary}
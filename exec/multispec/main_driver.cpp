@@ -519,6 +519,10 @@ void main_driver(const char* argv)
 
     }
 
+    // build the GMRES solver (Krylov vectors and multigrid hierarchies) once
+    // and reuse it every time step
+    GMRES gmres(ba,dmap,geom);
+
     // Time stepping loop
     for(int istep=init_step; istep<=max_step; ++istep) {
 
@@ -531,7 +535,7 @@ void main_driver(const char* argv)
                                     diff_mass_fluxdiv,stoch_mass_fluxdiv,stoch_mass_flux,
                                     grad_Epot_old,grad_Epot_new,
                                     charge_old,charge_new,Epot,permittivity,
-                                    sMassFlux,sMomFlux,
+                                    sMassFlux,sMomFlux,gmres,
                                     dt,time,istep,geom);
         }
         else if (algorithm_type == 6) {
@@ -541,7 +545,7 @@ void main_driver(const char* argv)
                                  diff_mass_fluxdiv,stoch_mass_fluxdiv,stoch_mass_flux,
                                  grad_Epot_old,grad_Epot_new,
                                  charge_old,charge_new,Epot,permittivity,
-                                 sMassFlux,sMomFlux,
+                                 sMassFlux,sMomFlux,gmres,
                                  dt,time,istep,geom);
         }
         else {
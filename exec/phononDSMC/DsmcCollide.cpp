@@ -66,6 +66,7 @@ void FhdParticleContainer::CalcSelections(Real dt)
 	{
 		const Box& tile_box  = mfi.tilebox();
 		const int grid_id = mfi.index();
+		const DsmcCellList cells = m_cell_index[grid_id].view();
 		const int tile_id = mfi.LocalTileIndex();
 		auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
 		auto& particles = particle_tile.GetArrayOfStructs();
@@ -88,8 +89,8 @@ void FhdParticleContainer::CalcSelections(Real dt)
 			{
 				for (int j_spec = i_spec; j_spec < nspecies; j_spec++) {
 					ij_spec = getSpeciesIndex(i_spec,j_spec);
-					np_i = m_cell_vectors[i_spec][grid_id][imap].size();
-					np_j = m_cell_vectors[j_spec][grid_id][imap].size();
+					np_i = cells.numParticles(i_spec,imap);
+					np_j = cells.numParticles(j_spec,imap);
 					vrmax = arrvrmax(i,j,k,i_spec);
 					crossSection = interproperties[ij_spec].csx;
 					NSel = 4.0*particle_neff*np_i*np_j*crossSection*vrmax*ocollisionCellVol*dt;
@@ -109,6 +110,7 @@ void FhdParticleContainer::CollideParticles(Real dt)
 	{
 		const Box& tile_box  = mfi.tilebox();
 		const int grid_id = mfi.index();
+		const DsmcCellList cells = m_cell_index[grid_id].view();
 		const int tile_id = mfi.LocalTileIndex();
 		auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
 		auto& particles = particle_tile.GetArrayOfStructs();
@@ -143,7 +145,7 @@ void FhdParticleContainer::CollideParticles(Real dt)
 			totalSel = 0;
 			for (int i_spec = 0; i_spec<nspecies; i_spec++)
 			{
-				np[i_spec] = m_cell_vectors[i_spec][grid_id][imap].size();
+				np[i_spec] = cells.numParticles(i_spec,imap);
 				for (int j_spec = i_spec; j_spec < nspecies; j_spec++)
 				{
 					ij_spec = getSpeciesIndex(i_spec,j_spec);
@@ -181,8 +183,8 @@ void FhdParticleContainer::CollideParticles(Real dt)
 				vrmax = arrvrmax(i,j,k,specij);
 				pindxi = floor(amrex::Random()*np[speci]);
 				pindxj = floor(amrex::Random()*np[specj]);
-				pindxi = m_cell_vectors[speci][grid_id][imap][pindxi];
-				pindxj = m_cell_vectors[specj][grid_id][imap][pindxj];
+				pindxi = cells.particles(speci,imap)[pindxi];
+				pindxj = cells.particles(specj,imap)[pindxj];
 				ParticleType &	parti = particles[pindxi];
 				ParticleType & partj = particles[pindxj];
 
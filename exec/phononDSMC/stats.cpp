@@ -21,6 +21,7 @@ void FhdParticleContainer::EvaluateStatsPhonon(MultiFab& mfcuInst,
         
     for (FhdParIter pti(* this, lev); pti.isValid(); ++pti) {
         const int grid_id = pti.index();
+        const DsmcCellList cells = m_cell_index[grid_id].view();
         const int tile_id = pti.LocalTileIndex();
         const Box& tile_box  = pti.tilebox();
                 
@@ -51,13 +52,13 @@ void FhdParticleContainer::EvaluateStatsPhonon(MultiFab& mfcuInst,
             long imap = tile_box.index(iv);
 
             for (int l=0; l<nspecies; l++) {
-                long np_spec = m_cell_vectors[l][grid_id][imap].size();
+                long np_spec = cells.numParticles(l,imap);
                 
                 cuInst(i,j,k,0) += np_spec;
 
                 // Read particle data
                 for (int m=0; m<np_spec; m++) {
-                    int pind = m_cell_vectors[l][grid_id][imap][m];
+                    int pind = cells.particles(l,imap)[m];
                     //int pind = 1;
                     ParticleType & p = particles[pind];
                     
@@ -25,6 +25,8 @@ std::string cufftErrorToString (const cufftResult& err)
 }
 #endif
 
+static std::shared_ptr<StructFactFFTPlan> GetFFTPlan(const Box& domain, int ncomp);
+
 StructFact::StructFact()
 {}
 
@@ -197,11 +199,18 @@ void StructFact::define(const BoxArray& ba_in, const DistributionMapping& dmap_i
   }
   //////////////////////////////////////////////////////
 
+  // The covariances are accumulated on the half spectrum (0 <= i <= nx/2) using the
+  // layout of the FFT; ba_in/dmap_in are only used when expanding to the full grid for output
+  ba_full = ba_in;
+  dmap_full = dmap_in;
+
+  fft_plan = GetFFTPlan(ba_in.minimalBox(), NVARU);
+
   // Note that we are defining with NO ghost cells
 
-  cov_real.define(ba_in, dmap_in, NCOV, 0);
-  cov_imag.define(ba_in, dmap_in, NCOV, 0);
-  cov_mag.define( ba_in, dmap_in, NCOV, 0);
+  cov_real.define(fft_plan->ba_spectral, fft_plan->dmap, NCOV, 0);
+  cov_imag.define(fft_plan->ba_spectral, fft_plan->dmap, NCOV, 0);
+  cov_mag.define( fft_plan->ba_spectral, fft_plan->dmap, NCOV, 0);
   cov_real.setVal(0.0);
   cov_imag.setVal(0.0);
   cov_mag.setVal( 0.0);
@@ -225,66 +234,75 @@ void StructFact::FortStructure(const MultiFab& variables, const Geometry& geom,
 
   BL_PROFILE_VAR("StructFact::FortStructure()",FortStructure);
 
-  const BoxArray& ba = variables.boxArray();
-  const DistributionMapping& dm = variables.DistributionMap();
-  
-  MultiFab variables_dft_real, variables_dft_imag;
-  variables_dft_real.define(ba, dm, NVAR, 0);
-  variables_dft_imag.define(ba, dm, NVAR, 0);
-
-  ComputeFFT(variables, variables_dft_real, variables_dft_imag, geom);
-
-  // temporary storage built on BoxArray and DistributionMapping of "variables"
-  // One case where "variables" and "cov_real/imag/mag" may have different DistributionMappings
-  // is for flattened MFs with one grid newly built flattened MFs may be on a different
-  // processor than the flattened MF used to build cov_real/imag/mag
-  // or in general, problems that are not perfectly load balanced
-  MultiFab cov_temp;
-  cov_temp.define(ba, dm, 1, 0);
-
-  // temporary storage built on BoxArray and DistributionMapping of "cov_real/imag/mag"
-  MultiFab cov_temp2;
-  cov_temp2.define(cov_real.boxArray(), cov_real.DistributionMap(), 1, 0);
-  
-  int index = 0;
-  for (int n=0; n<NCOV; n++) {
-    int i = s_pairA[n];
-    int j = s_pairB[n];
-    
-    // Compute temporary real and imaginary components of covariance
-
-    // Real component of covariance
-    cov_temp.setVal(0.0);
-    MultiFab::AddProduct(cov_temp,variables_dft_real,i,variables_dft_real,j,0,1,0);
-    MultiFab::AddProduct(cov_temp,variables_dft_imag,i,variables_dft_imag,j,0,1,0);
-
-    // copy into a MF with same ba and dm as cov_real/imag/mag
-    cov_temp2.ParallelCopy(cov_temp,0,0,1);
-        
-    if (reset == 1) {
-        MultiFab::Copy(cov_real,cov_temp2,0,index,1,0);
-    } else {        
-        MultiFab::Add(cov_real,cov_temp2,0,index,1,0);
-    }
+  // half spectrum of the variables in var_u; real parts followed by imaginary parts
+  ComputeFFT(variables, geom);
 
-    // Imaginary component of covariance
-    cov_temp.setVal(0.0);
-    MultiFab::AddProduct(cov_temp,variables_dft_imag,i,variables_dft_real,j,0,1,0);
-    cov_temp.mult(-1.0,0);
-    MultiFab::AddProduct(cov_temp,variables_dft_real,i,variables_dft_imag,j,0,1,0);
+  const MultiFab& spectral = fft_plan->spectral;
 
-    // copy into a MF with same ba and dm as cov_real/imag/mag
-    cov_temp2.ParallelCopy(cov_temp,0,0,1);
-    
-    if (reset == 1) {
-        MultiFab::Copy(cov_imag,cov_temp2,0,index,1,0);
-    } else {
-        MultiFab::Add(cov_imag,cov_temp2,0,index,1,0);
-    }
+  // position of each variable in var_u, i.e., its component in the spectrum
+  Vector<int> spectral_comp(NVAR,-1);
+  for (int n=0; n<NVARU; n++) {
+      spectral_comp[var_u[n]] = n;
+  }
 
-    index++;
+  // define() and ComputeFFT() keep the covariances on the layout of the FFT, so all NCOV
+  // real and imaginary running sums are updated in a single sweep over the spectrum
+  AMREX_ASSERT(cov_real.boxArray() == spectral.boxArray() &&
+               cov_real.DistributionMap() == spectral.DistributionMap());
 
+  Vector<int> compA_host(NCOV);
+  Vector<int> compB_host(NCOV);
+  for (int n=0; n<NCOV; n++) {
+      compA_host[n] = spectral_comp[s_pairA[n]];
+      compB_host[n] = spectral_comp[s_pairB[n]];
   }
+  Gpu::DeviceVector<int> compA_vect(NCOV);
+  Gpu::DeviceVector<int> compB_vect(NCOV);
+  Gpu::copy(Gpu::hostToDevice, compA_host.begin(), compA_host.end(), compA_vect.begin());
+  Gpu::copy(Gpu::hostToDevice, compB_host.begin(), compB_host.end(), compB_vect.begin());
+  int const * const AMREX_RESTRICT compA = compA_vect.dataPtr();
+  int const * const AMREX_RESTRICT compB = compB_vect.dataPtr();
+
+  int ncov = NCOV;
+  int nvaru = NVARU;
+  int reset_gpu = reset;
+
+  for (MFIter mfi(cov_real,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+      const Box& bx = mfi.tilebox();
+
+      const Array4<Real const>& spec = spectral.const_array(mfi);
+      const Array4<Real>& cr = cov_real.array(mfi);
+      const Array4<Real>& ci = cov_imag.array(mfi);
+
+      amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+      {
+          for (int n=0; n<ncov; ++n) {
+              int a = compA[n];
+              int b = compB[n];
+
+              Real ra = spec(i,j,k,a);
+              Real ia = spec(i,j,k,nvaru+a);
+              Real rb = spec(i,j,k,b);
+              Real ib = spec(i,j,k,nvaru+b);
+
+              // conj(F_a) * F_b
+              Real re = ra*rb + ia*ib;
+              Real im = ra*ib - ia*rb;
+
+              if (reset_gpu == 1) {
+                  cr(i,j,k,n) = re;
+                  ci(i,j,k,n) = im;
+              } else {
+                  cr(i,j,k,n) += re;
+                  ci(i,j,k,n) += im;
+              }
+          }
+      });
+  }
+
+  // compA_vect and compB_vect must outlive the kernels
+  Gpu::streamSynchronize();
 
   bool write_data = false;
   if (write_data) {
@@ -315,273 +333,430 @@ void StructFact::Reset() {
     
 }
 
-void StructFact::ComputeFFT(const MultiFab& variables,
-			    MultiFab& variables_dft_real, 
-			    MultiFab& variables_dft_imag,
-			    const Geometry& geom) {
-
-    BL_PROFILE_VAR("StructFact::ComputeFFT()", ComputeFFT);
+#ifndef AMREX_USE_CUDA
+// one-time FFTW setup; loads the wisdom file (if any) on the IOProcessor and
+// shares it with all ranks so plans built with FFTW_MEASURE/PATIENT are cheap to rebuild
+static void InitFFTW()
+{
+    static bool fftw_initialized = false;
+    if (fftw_initialized) return;
 
-#ifdef AMREX_USE_CUDA
-    Print() << "Using cuFFT\n";
-#else
-    Print() << "Using FFTW\n";
+#ifdef AMREX_USE_MPI
+    fftw_mpi_init();
 #endif
 
-    bool is_flattened = false;
-
-    long npts;
+    if (!struct_fact_fftw_wisdom.empty()) {
+        if (ParallelDescriptor::IOProcessor()) {
+            if (fftw_import_wisdom_from_filename(struct_fact_fftw_wisdom.c_str())) {
+                Print() << "Imported FFTW wisdom from " << struct_fact_fftw_wisdom << "\n";
+            } else {
+                Print() << "Could not import FFTW wisdom from " << struct_fact_fftw_wisdom << "\n";
+            }
+        }
+#ifdef AMREX_USE_MPI
+        fftw_mpi_broadcast_wisdom(ParallelDescriptor::Communicator());
+#endif
+    }
 
-    // Initialize the boxarray "ba_onegrid" from the single box "domain"
-    BoxArray ba_onegrid;
-    {
-      Box domain = geom.Domain();
-      ba_onegrid.define(domain);
+    fftw_initialized = true;
+}
 
-      if (domain.bigEnd(AMREX_SPACEDIM-1) == 0) {
-          is_flattened = true;
-      }
+// write the accumulated wisdom from all ranks to disk
+static void SaveFFTWWisdom()
+{
+    if (struct_fact_fftw_wisdom.empty() || struct_fact_fftw_planner == 0) return;
 
-#if (AMREX_SPACEDIM == 2)
-      npts = (domain.length(0)*domain.length(1));
-#elif (AMREX_SPACEDIM == 3)
-      npts = (domain.length(0)*domain.length(1)*domain.length(2));
+#ifdef AMREX_USE_MPI
+    fftw_mpi_gather_wisdom(ParallelDescriptor::Communicator());
+#endif
+    if (ParallelDescriptor::IOProcessor()) {
+        if (!fftw_export_wisdom_to_filename(struct_fact_fftw_wisdom.c_str())) {
+            Print() << "Could not export FFTW wisdom to " << struct_fact_fftw_wisdom << "\n";
+        }
+    }
+}
 #endif
 
+StructFactFFTPlan::~StructFactFFTPlan()
+{
+#ifdef AMREX_USE_CUDA
+    if (plan_built) {
+        cufftDestroy(forward_plan);
     }
+    if (fft_in)  The_Device_Arena()->free(fft_in);
+    if (fft_out) The_Device_Arena()->free(fft_out);
+#else
+    if (plan_built) {
+        fftw_destroy_plan(forward_plan);
+    }
+    if (fft_in)  fftw_free(fft_in);
+    if (fft_out) fftw_free(fft_out);
+#endif
+}
 
-    Real sqrtnpts = std::sqrt(npts);
+// Build the FFT layout, work buffers and forward plan for this domain.
+// All ncomp selected variables are transformed together by one batched plan
+static std::shared_ptr<StructFactFFTPlan> BuildFFTPlan(const Box& domain, int ncomp) {
 
-    DistributionMapping dmap_onegrid(ba_onegrid);
+    BL_PROFILE_VAR("BuildFFTPlan()", BuildFFTPlan);
 
-    // we will take one FFT at a time and copy the answer into the
-    // corresponding component
-    MultiFab variables_onegrid;
-    MultiFab variables_dft_real_onegrid;
-    MultiFab variables_dft_imag_onegrid;
-    variables_onegrid.define(ba_onegrid, dmap_onegrid, 1, 0);
-    variables_dft_real_onegrid.define(ba_onegrid, dmap_onegrid, 1, 0);
-    variables_dft_imag_onegrid.define(ba_onegrid, dmap_onegrid, 1, 0);
+#ifndef AMREX_USE_CUDA
+    InitFFTW();
+#endif
 
-//    fftw_mpi_init();
+    std::shared_ptr<StructFactFFTPlan> fft_plan = std::make_shared<StructFactFFTPlan>();
+    StructFactFFTPlan& plan = *fft_plan;
 
-#ifdef AMREX_USE_CUDA
-    using FFTplan = cufftHandle;
-    using FFTcomplex = cuDoubleComplex;
-#else
-    using FFTplan = fftw_plan;
-    using FFTcomplex = fftw_complex;
-#endif
+    plan.domain = domain;
+    plan.ncomp = ncomp;
 
-    // contain to store FFT - note it is shrunk by "half" in x
-    Vector<std::unique_ptr<BaseFab<GpuComplex<Real> > > > spectral_field;
+    bool is_flattened = (domain.bigEnd(AMREX_SPACEDIM-1) == 0);
 
-    Vector<FFTplan> forward_plan;
+    // dimensionality of the transform; slabs (if any) are cut in the last transformed direction
+    plan.fft_rank = is_flattened ? AMREX_SPACEDIM-1 : AMREX_SPACEDIM;
+    int slab_dir = plan.fft_rank-1;
 
-    // for CUDA builds we only need to build the plan once; track whether we did
-    bool built_plan = false;
-    
-    for (int comp=0; comp<NVAR; comp++) {
+    IntVect fft_size = domain.length();
 
-        bool comp_fft = false;
-        for (int i=0; i<NVARU; i++) {
-            if (comp == var_u[i]) {
-                comp_fft = true;
-                break;
-            }
-        }
+    plan.sqrtnpts = std::sqrt(domain.numPts());
 
-	if (comp_fft == false) continue;
+    // number of complex values in x in the half spectrum
+    plan.nx_spectral = fft_size[0]/2 + 1;
 
-        variables_onegrid.ParallelCopy(variables,comp,0,1);
+    // the remaining modes are complex conjugates of modes in the half spectrum;
+    // when expanding to the full grid we store conj(F(i,j,k)) at index (-i,-j,-k)
+    // for 1 <= i <= (nx-1)/2 and let a periodic ParallelCopy wrap them onto (nx-i,ny-j,nz-k)
+    plan.nx_mirror = (fft_size[0]-1)/2;
 
-        if (!built_plan) {
+    plan.period = Periodicity(fft_size);
 
-            for (MFIter mfi(variables_onegrid); mfi.isValid(); ++mfi) {
+    // FFTW and cuFFT use row-major ordering, so dimensions are listed from slowest
+    // to fastest; FFTW-MPI distributes the data over the first (slowest) dimension
+    ptrdiff_t n[AMREX_SPACEDIM];
+    ptrdiff_t n_spectral[AMREX_SPACEDIM];
+    for (int d=0; d<plan.fft_rank; ++d) {
+        n[d]          = fft_size[plan.fft_rank-1-d];
+        n_spectral[d] = fft_size[plan.fft_rank-1-d];
+    }
+    n_spectral[plan.fft_rank-1] = plan.nx_spectral;
 
-                // grab a single box including ghost cell range
-                Box realspace_bx = mfi.fabbox();
+#if !defined(AMREX_USE_CUDA) && defined(AMREX_USE_MPI)
+    // FFTW-MPI cannot do 1D real-to-complex transforms, so flattened 2D problems
+    // always use the single-grid path
+    plan.distributed = (struct_fact_fft_type == 1 && plan.fft_rank > 1);
+#endif
 
-                // size of box including ghost cell range
-                IntVect fft_size = realspace_bx.length(); // This will be different for hybrid FFT
+    // work buffer sizes, in units of Real and complex values
+    long alloc_real = 0;
+    long alloc_complex = 0;
+
+    // list of real-space boxes and the ranks that own them
+    BoxList bl_real;
+    Vector<int> pmap;
+
+    if (plan.distributed) {
+#if !defined(AMREX_USE_CUDA) && defined(AMREX_USE_MPI)
+        MPI_Comm comm = ParallelDescriptor::Communicator();
+
+        ptrdiff_t local_n0, local_0_start;
+        ptrdiff_t alloc_local = fftw_mpi_local_size_many(plan.fft_rank, n_spectral, ncomp,
+                                                         FFTW_MPI_DEFAULT_BLOCK, comm,
+                                                         &local_n0, &local_0_start);
+
+        // FFTW-MPI real input is padded in the fastest dimension to 2*(nx/2+1)
+        // for out-of-place as well as in-place transforms
+        plan.nx_padded = 2*plan.nx_spectral;
+        alloc_real    = 2*alloc_local;
+        alloc_complex =   alloc_local;
+
+        // FFTW-MPI batches interleave the components at each point
+        plan.in_stride  = ncomp;
+        plan.in_dist    = 1;
+        plan.out_stride = ncomp;
+        plan.out_dist   = 1;
+
+        // every rank needs to know the full slab distribution to build the BoxArray
+        int nprocs = ParallelDescriptor::NProcs();
+        long slab_local[2] = {(long) local_n0, (long) local_0_start};
+        Vector<long> slab_all(2*nprocs);
+        MPI_Allgather(slab_local, 2, MPI_LONG, slab_all.dataPtr(), 2, MPI_LONG, comm);
+
+        // ranks whose slab is empty own no boxes but still take part in the transform
+        for (int p=0; p<nprocs; ++p) {
+            if (slab_all[2*p] > 0) {
+                Box bx = domain;
+                bx.setSmall(slab_dir, domain.smallEnd(slab_dir) + slab_all[2*p+1]);
+                bx.setBig  (slab_dir, domain.smallEnd(slab_dir) + slab_all[2*p+1] + slab_all[2*p] - 1);
+                bl_real.push_back(bx);
+                pmap.push_back(p);
+            }
+        }
+#endif
+    } else {
+        // the whole domain on the rank chosen by the default DistributionMapping
+        plan.nx_padded = fft_size[0];
+        bl_real.push_back(domain);
+        pmap.push_back(DistributionMapping(BoxArray(domain))[0]);
+
+        // serial FFTW and cuFFT batches store one component after another
+        plan.in_stride  = 1;
+        plan.in_dist    = domain.numPts();
+        plan.out_stride = 1;
+        plan.out_dist   = (domain.numPts()/fft_size[0])*plan.nx_spectral;
+
+        if (pmap[0] == ParallelDescriptor::MyProc()) {
+            alloc_real    = ncomp*plan.in_dist;
+            alloc_complex = ncomp*plan.out_dist;
+        }
+    }
 
-                // this is the size of the box, except the 0th component is 'halved plus 1'
-                IntVect spectral_bx_size = fft_size;
-                spectral_bx_size[0] = fft_size[0]/2 + 1;
+    // the half spectrum lives on the same boxes restricted to 0 <= i <= nx/2
+    BoxList bl_spectral, bl_mirror;
+    for (const Box& bx_real : bl_real) {
+        Box bx = bx_real;
+        bx.setBig(0, plan.nx_spectral-1);
+        bl_spectral.push_back(bx);
+
+        if (plan.nx_mirror > 0) {
+            bx.setSmall(0, 1);
+            bx.setBig  (0, plan.nx_mirror);
+            bl_mirror.push_back(Box(-bx.bigEnd(), -bx.smallEnd()));
+        }
+    }
 
-                // spectral box
-                Box spectral_bx = Box(IntVect(0), spectral_bx_size - IntVect(1));
+    plan.ba_real    .define(std::move(bl_real));
+    plan.ba_spectral.define(std::move(bl_spectral));
+    plan.ba_mirror  .define(std::move(bl_mirror));
+    plan.dmap.define(pmap);
 
-                spectral_field.emplace_back(new BaseFab<GpuComplex<Real> >(spectral_bx,1,
-                                                                       The_Device_Arena()));
-                spectral_field.back()->setVal<RunOn::Device>(0.0); // touch the memory
+    // the spectrum holds the real parts of all components followed by the imaginary parts
+    plan.variables_fft.define(plan.ba_real, plan.dmap, ncomp, 0);
+    plan.spectral     .define(plan.ba_spectral, plan.dmap, 2*ncomp, 0);
 
-                FFTplan fplan;
+    // ranks without data still get a (tiny) buffer so FFTW-MPI has valid pointers
+    alloc_real    = std::max(alloc_real,   1L);
+    alloc_complex = std::max(alloc_complex,1L);
 
 #ifdef AMREX_USE_CUDA
-                if (is_flattened) {
-#if (AMREX_SPACEDIM == 2)
-                    cufftResult result = cufftPlan1d(&fplan, fft_size[0], CUFFT_D2Z, 1);
-                    if (result != CUFFT_SUCCESS) {
-                        amrex::AllPrint() << " cufftplan1d forward failed! Error: "
-                                          << cufftErrorToString(result) << "\n";
-                    }
-#elif (AMREX_SPACEDIM == 3)
-                    cufftResult result = cufftPlan2d(&fplan, fft_size[1], fft_size[0], CUFFT_D2Z);
-                    if (result != CUFFT_SUCCESS) {
-                        amrex::AllPrint() << " cufftplan2d forward failed! Error: "
-                                          << cufftErrorToString(result) << "\n";
-                    }
-#endif
-                } else {
-#if (AMREX_SPACEDIM == 2)
-                    cufftResult result = cufftPlan2d(&fplan, fft_size[1], fft_size[0], CUFFT_D2Z);
-                    if (result != CUFFT_SUCCESS) {
-                        amrex::AllPrint() << " cufftplan2d forward failed! Error: "
-                                          << cufftErrorToString(result) << "\n";
-                    }
-#elif (AMREX_SPACEDIM == 3)
-                    cufftResult result = cufftPlan3d(&fplan, fft_size[2], fft_size[1], fft_size[0], CUFFT_D2Z);
-                    if (result != CUFFT_SUCCESS) {
-                        amrex::AllPrint() << " cufftplan3d forward failed! Error: "
-                                          << cufftErrorToString(result) << "\n";
-                    }
-#endif
-                }
-#else // host
+    plan.fft_in  = static_cast<Real*>(The_Device_Arena()->alloc(alloc_real*sizeof(Real)));
+    plan.fft_out = static_cast<GpuComplex<Real>*>
+        (The_Device_Arena()->alloc(alloc_complex*sizeof(GpuComplex<Real>)));
+
+    if (pmap[0] == ParallelDescriptor::MyProc()) {
+        int n_int[AMREX_SPACEDIM];
+        for (int d=0; d<plan.fft_rank; ++d) {
+            n_int[d] = n[d];
+        }
+        cufftResult result = cufftPlanMany(&plan.forward_plan, plan.fft_rank, n_int,
+                                           NULL, 1, (int) plan.in_dist, NULL, 1, (int) plan.out_dist,
+                                           CUFFT_D2Z, ncomp);
+        if (result != CUFFT_SUCCESS) {
+            amrex::AllPrint() << " cufftPlanMany forward failed! Error: "
+                              << cufftErrorToString(result) << "\n";
+        }
+        plan.plan_built = true;
+    }
+#else
+    plan.fft_in  = fftw_alloc_real(alloc_real);
+    plan.fft_out = reinterpret_cast<GpuComplex<Real>*>(fftw_alloc_complex(alloc_complex));
+
+    unsigned planner_flag = FFTW_ESTIMATE;
+    if (struct_fact_fftw_planner == 1) {
+        planner_flag = FFTW_MEASURE;
+    } else if (struct_fact_fftw_planner == 2) {
+        planner_flag = FFTW_PATIENT;
+    }
 
-                if (is_flattened) {
-#if (AMREX_SPACEDIM == 2)
-                    fplan = fftw_plan_dft_r2c_1d(fft_size[0],
-                                                 variables_onegrid[mfi].dataPtr(),
-                                                 reinterpret_cast<FFTcomplex*>
-                                                 (spectral_field.back()->dataPtr()),
-                                                 FFTW_ESTIMATE);
-#elif (AMREX_SPACEDIM == 3)
-                    fplan = fftw_plan_dft_r2c_2d(fft_size[1], fft_size[0],
-                                                 variables_onegrid[mfi].dataPtr(),
-                                                 reinterpret_cast<FFTcomplex*>
-                                                 (spectral_field.back()->dataPtr()),
-                                                 FFTW_ESTIMATE);
+    if (plan.distributed) {
+#ifdef AMREX_USE_MPI
+        plan.forward_plan = fftw_mpi_plan_many_dft_r2c(plan.fft_rank, n, ncomp,
+                                               FFTW_MPI_DEFAULT_BLOCK,
+                                               FFTW_MPI_DEFAULT_BLOCK,
+                                               plan.fft_in,
+                                               reinterpret_cast<fftw_complex*>(plan.fft_out),
+                                               ParallelDescriptor::Communicator(),
+                                               planner_flag);
+        plan.plan_built = true;
 #endif
-                } else {
-#if (AMREX_SPACEDIM == 2)
-                    fplan = fftw_plan_dft_r2c_2d(fft_size[1], fft_size[0],
-                                                 variables_onegrid[mfi].dataPtr(),
-                                                 reinterpret_cast<FFTcomplex*>
-                                                 (spectral_field.back()->dataPtr()),
-                                                 FFTW_ESTIMATE);
-#elif (AMREX_SPACEDIM == 3)
-                    fplan = fftw_plan_dft_r2c_3d(fft_size[2], fft_size[1], fft_size[0],
-                                                 variables_onegrid[mfi].dataPtr(),
-                                                 reinterpret_cast<FFTcomplex*>
-                                                 (spectral_field.back()->dataPtr()),
-                                                 FFTW_ESTIMATE);
+    } else if (pmap[0] == ParallelDescriptor::MyProc()) {
+        int n_int[AMREX_SPACEDIM];
+        for (int d=0; d<plan.fft_rank; ++d) {
+            n_int[d] = n[d];
+        }
+        plan.forward_plan = fftw_plan_many_dft_r2c(plan.fft_rank, n_int, ncomp,
+                                           plan.fft_in, NULL, 1, plan.in_dist,
+                                           reinterpret_cast<fftw_complex*>(plan.fft_out), NULL, 1, plan.out_dist,
+                                           planner_flag);
+        plan.plan_built = true;
+    }
+
+    SaveFFTWWisdom();
 #endif
-                }
+
+#ifdef AMREX_USE_CUDA
+    Print() << "Using cuFFT\n";
+#else
+    Print() << (plan.distributed ? "Using FFTW-MPI\n" : "Using FFTW\n");
 #endif
 
-                forward_plan.push_back(fplan);
-            }
+    return fft_plan;
+}
 
-	    built_plan = true;
-        
+// Plans are built once and shared by all StructFact objects with the same domain and
+// number of transformed variables (e.g., the per-slice StructFacts in compressible_stag),
+// so steady-state sampling only pays for the transform itself
+static std::shared_ptr<StructFactFFTPlan> GetFFTPlan(const Box& domain, int ncomp) {
+
+    static Vector<std::weak_ptr<StructFactFFTPlan> > plans;
+
+    for (auto& p : plans) {
+        std::shared_ptr<StructFactFFTPlan> plan = p.lock();
+        if (plan && plan->domain == domain && plan->ncomp == ncomp) {
+            return plan;
         }
+    }
 
-        ParallelDescriptor::Barrier();
+    std::shared_ptr<StructFactFFTPlan> plan = BuildFFTPlan(domain, ncomp);
 
-        // ForwardTransform
-        for (MFIter mfi(variables_onegrid); mfi.isValid(); ++mfi) {
-            int i = mfi.LocalIndex();
-#ifdef AMREX_USE_CUDA
-            cufftSetStream(forward_plan[i], amrex::Gpu::gpuStream());
-            cufftResult result = cufftExecD2Z(forward_plan[i],
-                                              variables_onegrid[mfi].dataPtr(),
-                                              reinterpret_cast<FFTcomplex*>
-                                                  (spectral_field[i]->dataPtr()));
-            if (result != CUFFT_SUCCESS) {
-	      amrex::AllPrint() << " forward transform using cufftExec failed! Error: "
-				<< cufftErrorToString(result) << "\n";
-	    }
-#else
-            fftw_execute(forward_plan[i]);
-#endif
+    // reuse an expired slot if there is one
+    for (auto& p : plans) {
+        if (p.expired()) {
+            p = plan;
+            return plan;
         }
+    }
+    plans.push_back(plan);
 
-        // copy data to a full-sized MultiFab
-        // this involves copying the complex conjugate from the half-sized field
-        // into the appropriate place in the full MultiFab
-        for (MFIter mfi(variables_dft_real_onegrid); mfi.isValid(); ++mfi) {
-
-            Array4< GpuComplex<Real> > spectral = (*spectral_field[0]).array();
-
-            Array4<Real> const& realpart = variables_dft_real_onegrid.array(mfi);
-            Array4<Real> const& imagpart = variables_dft_imag_onegrid.array(mfi);
-
-            Box bx = mfi.fabbox();
-
-            amrex::ParallelFor(bx,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                if (i <= bx.length(0)/2) {
-                    // copy value
-                    realpart(i,j,k) = spectral(i,j,k).real();
-                    imagpart(i,j,k) = spectral(i,j,k).imag();
-                } else {
-                    // copy complex conjugate
-                    int iloc = bx.length(0)-i;
-                    int jloc, kloc;
-                    if (is_flattened) {
-#if (AMREX_SPACEDIM == 2)
-                        jloc = 0;
-#elif (AMREX_SPACEDIM == 3)
-                        jloc = (j == 0) ? 0 : bx.length(1)-j;
-#endif
-                        kloc = 0;
-                    } else {
-                        jloc = (j == 0) ? 0 : bx.length(1)-j;
-#if (AMREX_SPACEDIM == 2)
-                        kloc = 0;
-#elif (AMREX_SPACEDIM == 3)
-                        kloc = (k == 0) ? 0 : bx.length(2)-k;
-#endif
-                    }
+    return plan;
+}
 
-                    realpart(i,j,k) =  spectral(iloc,jloc,kloc).real();
-                    imagpart(i,j,k) = -spectral(iloc,jloc,kloc).imag();
-                }
+// Compute the half spectrum (0 <= i <= nx/2) of the selected variables
+// The result is stored in fft_plan->spectral, on the layout of the FFT, with the real parts
+// of the NVARU variables in var_u followed by their imaginary parts
+void StructFact::ComputeFFT(const MultiFab& variables,
+			    const Geometry& geom) {
+
+    BL_PROFILE_VAR("StructFact::ComputeFFT()", ComputeFFT);
 
-                realpart(i,j,k) /= sqrtnpts;
-                imagpart(i,j,k) /= sqrtnpts;
-            });
-
-            /*
-            amrex::ParallelFor(bx,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                std::cout << "HACKFFT " << i << " " << j << " " << k << " "
-                          << realpart(i,j,k) << " + " << imagpart(i,j,k) << "i"
-                          << std::endl;
-            });
-            */
+    if (!fft_plan || fft_plan->domain != geom.Domain() || fft_plan->ncomp != NVARU) {
+        fft_plan = GetFFTPlan(geom.Domain(), NVARU);
+
+        // the covariances live on the layout of the FFT, so move them to the new one;
+        // samples accumulated on the old domain cannot be carried over
+        if (cov_real.boxArray() != fft_plan->ba_spectral ||
+            cov_real.DistributionMap() != fft_plan->dmap) {
+            cov_real.define(fft_plan->ba_spectral, fft_plan->dmap, NCOV, 0);
+            cov_imag.define(fft_plan->ba_spectral, fft_plan->dmap, NCOV, 0);
+            cov_mag.define( fft_plan->ba_spectral, fft_plan->dmap, NCOV, 0);
+            cov_real.setVal(0.0);
+            cov_imag.setVal(0.0);
+            cov_mag.setVal( 0.0);
+            nsamples = 0;
         }
+    }
+
+    StructFactFFTPlan& plan = *fft_plan;
 
-        variables_dft_real.ParallelCopy(variables_dft_real_onegrid,0,comp,1);
-        variables_dft_imag.ParallelCopy(variables_dft_imag_onegrid,0,comp,1);
+    const BoxArray& ba = variables.boxArray();
+    const DistributionMapping& dm = variables.DistributionMap();
 
+    MultiFab& variables_fft = plan.variables_fft;
+
+    int ncomp = NVARU;
+
+    Real* fft_in = plan.fft_in;
+    GpuComplex<Real>* fft_out = plan.fft_out;
+    long in_stride  = plan.in_stride;
+    long in_dist    = plan.in_dist;
+    long out_stride = plan.out_stride;
+    long out_dist   = plan.out_dist;
+    int nx_padded   = plan.nx_padded;
+    int nx_spectral = plan.nx_spectral;
+    Real sqrtnpts   = plan.sqrtnpts;
+
+    // redistribute all selected variables at once
+    // var_u is sorted, so if it has no gaps the selected variables are already contiguous;
+    // otherwise gather them locally first so there is still only one ParallelCopy
+    if (var_u[NVARU-1] - var_u[0] == NVARU-1) {
+        variables_fft.ParallelCopy(variables,var_u[0],0,ncomp);
+    } else {
+        MultiFab variables_u(ba, dm, ncomp, 0);
+        for (int n=0; n<ncomp; ++n) {
+            MultiFab::Copy(variables_u,variables,var_u[n],n,1,0);
+        }
+        variables_fft.ParallelCopy(variables_u,0,0,ncomp);
+    }
+
+    // pack into the FFT input buffer (padded in x for FFTW-MPI)
+    for (MFIter mfi(variables_fft); mfi.isValid(); ++mfi) {
+
+        const Box& bx = mfi.validbox();
+        const auto lo  = amrex::lbound(bx);
+        const auto len = amrex::length(bx);
+
+        const Array4<Real const>& var = variables_fft.const_array(mfi);
+
+        amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            long index = ((long)(k-lo.z)*len.y + (j-lo.y))*nx_padded + (i-lo.x);
+            fft_in[index*in_stride + n*in_dist] = var(i,j,k,n);
+        });
     }
 
-    // destroy fft plan
-    for (int i = 0; i < forward_plan.size(); ++i) {
+    // ForwardTransform of all components
+    if (plan.plan_built) {
 #ifdef AMREX_USE_CUDA
-        cufftDestroy(forward_plan[i]);
+        cufftSetStream(plan.forward_plan, amrex::Gpu::gpuStream());
+        cufftResult result = cufftExecD2Z(plan.forward_plan, fft_in,
+                                          reinterpret_cast<cuDoubleComplex*>(fft_out));
+        if (result != CUFFT_SUCCESS) {
+            amrex::AllPrint() << " forward transform using cufftExec failed! Error: "
+                              << cufftErrorToString(result) << "\n";
+        }
 #else
-        fftw_destroy_plan(forward_plan[i]);
+        fftw_execute(plan.forward_plan);
 #endif
     }
 
-//    fftw_mpi_cleanup();
+    // unpack the half spectrum
+    for (MFIter mfi(plan.spectral); mfi.isValid(); ++mfi) {
+
+        const Box& bx = mfi.validbox();
+        const auto lo  = amrex::lbound(bx);
+        const auto len = amrex::length(bx);
+
+        const Array4<Real>& spectral = plan.spectral.array(mfi);
+
+        amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            long index = ((long)(k-lo.z)*len.y + (j-lo.y))*nx_spectral + (i-lo.x);
+            spectral(i,j,k,n      ) = fft_out[index*out_stride + n*out_dist].real() / sqrtnpts;
+            spectral(i,j,k,ncomp+n) = fft_out[index*out_stride + n*out_dist].imag() / sqrtnpts;
+        });
+    }
+}
+
+// Compute the full (unshifted) spectrum of the selected variables on the layout of "variables";
+// the real and imaginary parts of variable var_u[n] go into component var_u[n]
+void StructFact::ComputeFFT(const MultiFab& variables,
+			    MultiFab& variables_dft_real,
+			    MultiFab& variables_dft_imag,
+			    const Geometry& geom) {
+
+    BL_PROFILE_VAR("StructFact::ComputeFFT()", ComputeFFT);
+
+    ComputeFFT(variables, geom);
+
+    const MultiFab& spectral = fft_plan->spectral;
 
+    MultiFab dft_half(spectral.boxArray(), spectral.DistributionMap(), 1, 0);
+
+    for (int n=0; n<NVARU; ++n) {
+        MultiFab::Copy(dft_half,spectral,n,0,1,0);
+        ExpandFFT(dft_half,variables_dft_real,var_u[n],0,IntVect(0));
+        MultiFab::Copy(dft_half,spectral,NVARU+n,0,1,0);
+        ExpandFFT(dft_half,variables_dft_imag,var_u[n],1,IntVect(0));
+    }
 }
 
 void StructFact::WritePlotFile(const int step, const Real time, const Geometry& geom,
@@ -615,14 +790,14 @@ void StructFact::WritePlotFile(const int step, const Real time, const Geometry&
   
   const std::string plotfilename1 = amrex::Concatenate(name,step,9);
   nPlot = NCOV;
-  plotfile.define(cov_mag.boxArray(), cov_mag.DistributionMap(), nPlot, 0);
+  plotfile.define(ba_full, dmap_full, nPlot, 0);
   varNames.resize(nPlot);
 
   for (int n=0; n<NCOV; n++) {
       varNames[n] = cov_names[n];
   }
   
-  MultiFab::Copy(plotfile, cov_mag, 0, 0, NCOV, 0); // copy structure factor into plotfile
+  ShiftFFT(cov_mag, plotfile, 0); // expand structure factor into plotfile
 
   Real dx = geom.CellSize(0);
   Real pi = 3.1415926535897932;
@@ -652,7 +827,7 @@ void StructFact::WritePlotFile(const int step, const Real time, const Geometry&
   
   const std::string plotfilename2 = amrex::Concatenate(name,step,9);
   nPlot = 2*NCOV;
-  plotfile.define(cov_mag.boxArray(), cov_mag.DistributionMap(), nPlot, 0);
+  plotfile.define(ba_full, dmap_full, nPlot, 0);
   varNames.resize(nPlot);
 
   int cnt = 0; // keep a counter for plotfile variables
@@ -670,8 +845,8 @@ void StructFact::WritePlotFile(const int step, const Real time, const Geometry&
       cnt++;
   }
 
-  MultiFab::Copy(plotfile,cov_real_temp,0,0,   NCOV,0);
-  MultiFab::Copy(plotfile,cov_imag_temp,0,NCOV,NCOV,0);
+  ShiftFFT(cov_real_temp,plotfile,0);
+  ShiftFFT(cov_imag_temp,plotfile,NCOV,1);
 
   // write a plotfile
   WriteSingleLevelPlotfile(plotfilename2,plotfile,varNames,geom2,time,step);
@@ -683,9 +858,23 @@ void StructFact::Finalize(MultiFab& cov_real_in, MultiFab& cov_imag_in,
   BL_PROFILE_VAR("StructFact::Finalize()",StructFactFinalize);
   
   Real nsamples_inv = 1.0/(Real)nsamples;
-  
-  ShiftFFT(cov_real_in,geom,zero_avg);
-  ShiftFFT(cov_imag_in,geom,zero_avg);
+
+  // zero out the k=0 mode
+  if (zero_avg == 1) {
+      const IntVect k0 = geom.Domain().smallEnd();
+      int ncov = NCOV;
+      for (MFIter mfi(cov_real_in); mfi.isValid(); ++mfi) {
+          if (mfi.validbox().contains(k0)) {
+              const Array4<Real>& cr = cov_real_in.array(mfi);
+              const Array4<Real>& ci = cov_imag_in.array(mfi);
+              amrex::ParallelFor(Box(k0,k0), ncov, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+              {
+                  cr(i,j,k,n) = 0.;
+                  ci(i,j,k,n) = 0.;
+              });
+          }
+      }
+  }
 
   cov_real_in.mult(nsamples_inv);
   for (int d=0; d<NCOV; d++) {
@@ -726,83 +915,104 @@ void StructFact::CallFinalize( const Geometry& geom,
 
 
 
-void StructFact::ShiftFFT(MultiFab& dft_out, const Geometry& geom, const int& zero_avg) {
+// Expand a half-spectrum MultiFab (on the FFT layout) into components dcomp, dcomp+1, ...
+// of the full-grid MultiFab dft_out, shifted so that the k=0 mode is at the center.
+// Set conjugate=1 if dft_half holds imaginary parts, so the mirrored modes are negated.
+void StructFact::ShiftFFT(const MultiFab& dft_half, MultiFab& dft_out, const int& dcomp,
+                          const int& conjugate) {
 
   BL_PROFILE_VAR("StructFact::ShiftFFT()",ShiftFFT);
 
+  IntVect fft_size = fft_plan->domain.length();
+
+  IntVect shift;
+  for (int d=0; d<AMREX_SPACEDIM; ++d) {
+      shift[d] = (fft_size[d]+1)/2;
+  }
+
+  ExpandFFT(dft_half, dft_out, dcomp, conjugate, shift);
+}
+
+// Expand a half-spectrum MultiFab into the full grid, moving mode (i,j,k) to (i,j,k)+shift
+// (modulo the domain); ShiftFFT() uses shift = (N+1)/2, ComputeFFT() uses shift = 0
+void StructFact::ExpandFFT(const MultiFab& dft_half, MultiFab& dft_out, const int& dcomp,
+                           const int& conjugate, const IntVect& shift) {
+
   /*
     Shifting rules:
 
     For domains from (0,0,0) to (Nx-1,Ny-1,Nz-1)
 
-    For any cells with i index >= Nx/2, these values are complex conjugates of the corresponding
-    entry where (Nx-i,Ny-j,Nz-k) UNLESS that index is zero, in which case you use 0.
+    Mode (i,j,k) is moved to ((i+(Nx+1)/2)%Nx, (j+(Ny+1)/2)%Ny, (k+(Nz+1)/2)%Nz).
+
+    Only the modes with 0 <= i <= Nx/2 are stored. For any cells with i index > Nx/2, these values
+    are complex conjugates of the corresponding entry where (Nx-i,Ny-j,Nz-k) UNLESS that index is
+    zero, in which case you use 0.
 
     e.g. for an 8^3 domain, any cell with i index 
 
     Cell (6,2,3) is complex conjugate of (2,6,5)
 
     Cell (4,1,0) is complex conjugate of (4,7,0)  (note that the FFT is computed for 0 <= i <= Nx/2)
+
+    We write the stored modes at their shifted index, and the conjugates at the shifted index of
+    (-i,-j,-k), and let a periodic ParallelCopy wrap both into the domain.
   */
 
-  BoxArray ba_onegrid;
-  {
-      Box domain = geom.Domain();
-      
-      // Initialize the boxarray "ba" from the single box "bx"
-      ba_onegrid.define(domain);
+  const StructFactFFTPlan& plan = *fft_plan;
+
+  if (dft_half.boxArray() != plan.ba_spectral || dft_half.DistributionMap() != plan.dmap) {
+      amrex::Error("StructFact::ExpandFFT() - input must be on the layout of the FFT");
   }
 
-  DistributionMapping dmap_onegrid(ba_onegrid);
+  const Dim3 s = shift.dim3();
 
-  MultiFab dft_onegrid;
-  MultiFab dft_onegrid_temp;
-  dft_onegrid     .define(ba_onegrid, dmap_onegrid, 1, 0);
-  dft_onegrid_temp.define(ba_onegrid, dmap_onegrid, 1, 0);
+  int ncomp = dft_half.nComp();
+  int nx_mirror = plan.nx_mirror;
+  Real mirror_sign = (conjugate == 1) ? -1. : 1.;
 
-  for (int d=0; d<NCOV; d++) {
-    dft_onegrid_temp.ParallelCopy(dft_out, d, 0, 1);
+  BoxArray ba_shifted = plan.ba_spectral;
+  ba_shifted.shift(shift);
+  MultiFab dft_shifted(ba_shifted, plan.dmap, ncomp, 0);
 
-    // Shift DFT by N/2+1 (pi)
-    for (MFIter mfi(dft_onegrid); mfi.isValid(); ++mfi) {
+  MultiFab mirror_shifted;
+  if (nx_mirror > 0) {
+      BoxArray ba_mirror_shifted = plan.ba_mirror;
+      ba_mirror_shifted.shift(shift);
+      mirror_shifted.define(ba_mirror_shifted, plan.dmap, ncomp, 0);
+  }
 
-        const Box& bx = mfi.tilebox();
+  for (MFIter mfi(dft_half); mfi.isValid(); ++mfi) {
 
-        const Array4<Real>& dft = dft_onegrid.array(mfi);
-        const Array4<Real>& dft_temp = dft_onegrid_temp.array(mfi);
+      const Box& bx = mfi.validbox();
 
-        if (zero_avg == 1) {
-#if (AMREX_SPACEDIM == 2)
-            dft_temp(bx.smallEnd(0),bx.smallEnd(1),0) = 0.;
-#elif (AMREX_SPACEDIM == 3)
-            dft_temp(bx.smallEnd(0),bx.smallEnd(1),bx.smallEnd(2)) = 0.;
-#endif
-        }
+      const Array4<Real const>& dft = dft_half.const_array(mfi);
+      const Array4<Real>& dft_s = dft_shifted.array(mfi);
 
-        int nx = bx.length(0);
-        int nxh = (nx+1)/2;
-        int ny = bx.length(1);
-        int nyh = (ny+1)/2;
-#if (AMREX_SPACEDIM == 3)
-        int nz = bx.length(2);
-        int nzh = (nz+1)/2;
-#endif
+      amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+      {
+          dft_s(i+s.x,j+s.y,k+s.z,n) = dft(i,j,k,n);
+      });
 
-        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-        {
-            int ip = (i+nxh)%nx;
-            int jp = (j+nyh)%ny;
-            int kp = 0;
-#if (AMREX_SPACEDIM == 3)
-            kp = (k+nzh)%nz;
-#endif
-            dft(ip,jp,kp) = dft_temp(i,j,k);
-        });
-    }
+      if (nx_mirror > 0) {
+
+          const Array4<Real>& mirror = mirror_shifted.array(mfi);
+
+          Box bx_mirror = bx;
+          bx_mirror.setSmall(0, 1);
+          bx_mirror.setBig  (0, nx_mirror);
 
-    dft_out.ParallelCopy(dft_onegrid, 0, d, 1);
+          amrex::ParallelFor(bx_mirror, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+          {
+              mirror(s.x-i,s.y-j,s.z-k,n) = mirror_sign*dft(i,j,k,n);
+          });
+      }
   }
 
+  dft_out.ParallelCopy(dft_shifted,0,dcomp,ncomp,IntVect(0),IntVect(0),plan.period);
+  if (nx_mirror > 0) {
+      dft_out.ParallelCopy(mirror_shifted,0,dcomp,ncomp,IntVect(0),IntVect(0),plan.period);
+  }
 }
 
 // integrate cov_mag over k shells
@@ -811,10 +1021,17 @@ void StructFact::IntegratekShells(const int& step, const Geometry& geom) {
     BL_PROFILE_VAR("StructFact::IntegratekShells",IntegratekShells);
 
     GpuArray<int,AMREX_SPACEDIM> center;
+    GpuArray<int,AMREX_SPACEDIM> nk;
+    GpuArray<int,AMREX_SPACEDIM> shift;
     for (int d=0; d<AMREX_SPACEDIM; ++d) {
         center[d] = n_cells[d]/2;
+        nk[d] = n_cells[d];
+        shift[d] = (n_cells[d]+1)/2;
     }
 
+    // modes 1 <= i <= (nx-1)/2 of the half spectrum also stand for their complex conjugate
+    int nx_mirror = (n_cells[0]-1)/2;
+
     int npts = n_cells[0]/2-1;
     int npts_sq = npts*npts;
 
@@ -850,23 +1067,38 @@ void StructFact::IntegratekShells(const int& step, const Geometry& geom) {
 
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
-            int ilen = amrex::Math::abs(i-center[0]);
-            int jlen = amrex::Math::abs(j-center[1]);
-            int klen = (AMREX_SPACEDIM == 3) ? amrex::Math::abs(k-center[2]) : 0;
-
-            Real dist = (ilen*ilen + jlen*jlen + klen*klen);
- //           int idist = (ilen*ilen + jlen*jlen + klen*klen);
-            dist = std::sqrt(dist);
-            
-            if ( dist <= center[0]-0.5) {
-	        dist = dist+0.5;
-                int cell = int(dist);
-                for (int d=0; d<AMREX_SPACEDIM; ++d) {
-		  amrex::HostDevice::Atomic::Add(&(phisum_gpu[cell]), cov(i,j,k,d));
-//		    phisum_large_gpu[idist]  += cov(i,j,k,d);
+            int nmodes = (i >= 1 && i <= nx_mirror) ? 2 : 1;
+
+            for (int m=0; m<nmodes; ++m) {
+
+                // index of this mode (m=0) or its conjugate (m=1) on the shifted full grid
+                int is = (m == 0) ? i : nk[0]-i;
+                int js = (m == 0) ? j : (nk[1]-j)%nk[1];
+                is = (is+shift[0])%nk[0];
+                js = (js+shift[1])%nk[1];
+                int ilen = amrex::Math::abs(is-center[0]);
+                int jlen = amrex::Math::abs(js-center[1]);
+                int klen = 0;
+#if (AMREX_SPACEDIM == 3)
+                int ks = (m == 0) ? k : (nk[2]-k)%nk[2];
+                ks = (ks+shift[2])%nk[2];
+                klen = amrex::Math::abs(ks-center[2]);
+#endif
+
+                Real dist = (ilen*ilen + jlen*jlen + klen*klen);
+ //               int idist = (ilen*ilen + jlen*jlen + klen*klen);
+                dist = std::sqrt(dist);
+
+                if ( dist <= center[0]-0.5) {
+                    dist = dist+0.5;
+                    int cell = int(dist);
+                    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+                        amrex::HostDevice::Atomic::Add(&(phisum_gpu[cell]), cov(i,j,k,d));
+//                      phisum_large_gpu[idist]  += cov(i,j,k,d);
+                    }
+                    amrex::HostDevice::Atomic::Add(&(phicnt_gpu[cell]),1);
+ //                   ++phicnt_large_gpu[idist];
                 }
-		amrex::HostDevice::Atomic::Add(&(phicnt_gpu[cell]),1);
- //               ++phicnt_large_gpu[idist];
             }
         });
     }
@@ -959,14 +1191,14 @@ void StructFact::AddToExternal(MultiFab& x_mag, MultiFab& x_realimag, const Geom
     Finalize(cov_real_temp, cov_imag_temp, geom, zero_avg);
 
     nPlot = NCOV;
-    plotfile.define(cov_mag.boxArray(), cov_mag.DistributionMap(), nPlot, 0);
-    MultiFab::Copy(plotfile, cov_mag, 0, 0, NCOV, 0); // copy structure factor into plotfile
+    plotfile.define(ba_full, dmap_full, nPlot, 0);
+    ShiftFFT(cov_mag, plotfile, 0); // expand structure factor into plotfile
     MultiFab::Add(x_mag,plotfile,0,0,NCOV,0);
 
     nPlot = 2*NCOV;
-    plotfile.define(cov_mag.boxArray(), cov_mag.DistributionMap(), nPlot, 0);
-    MultiFab::Copy(plotfile,cov_real_temp,0,0,   NCOV,0);
-    MultiFab::Copy(plotfile,cov_imag_temp,0,NCOV,NCOV,0);
+    plotfile.define(ba_full, dmap_full, nPlot, 0);
+    ShiftFFT(cov_real_temp,plotfile,0);
+    ShiftFFT(cov_imag_temp,plotfile,NCOV,1);
     MultiFab::Add(x_realimag,plotfile,0,0,2*NCOV,0);
 
 }
@@ -153,6 +153,9 @@ amrex::Real                   common::tau_la;
 amrex::Real                   common::tau_i;
 
 int                           common::struct_fact_int;
+int                           common::struct_fact_fft_type;
+int                           common::struct_fact_fftw_planner;
+std::string                   common::struct_fact_fftw_wisdom;
 int                           common::radialdist_int;
 int                           common::cartdist_int;
 int                           common::n_steps_skip;
@@ -204,6 +207,7 @@ int                        common::poisson_bottom_verbose;
 int                        common::poisson_max_iter;
 
 amrex::Real                common::poisson_rel_tol;
+int                        common::poisson_fft;
 AMREX_GPU_MANAGED amrex::Real common::permittivity;
 AMREX_GPU_MANAGED int      common::wall_mob;
 
@@ -227,6 +231,11 @@ int	                   common::zero_net_force;
 int                        common::crange;
 
 AMREX_GPU_MANAGED int      common::images;
+amrex::Real                common::coulomb_cutoff;
+amrex::Real                common::coulomb_damping;
+amrex::Real                common::p3m_alpha;
+amrex::Real                common::p3m_cutoff;
+int                        common::p3m_order;
 amrex::Vector<amrex::Real> common::eamp;
 amrex::Vector<amrex::Real> common::efreq;
 amrex::Vector<amrex::Real> common::ephase;
@@ -522,6 +531,9 @@ void InitializeCommonNamespace() {
 
     // structure factor and radial/cartesian pair correlation function analysis
     struct_fact_int = 0;
+    struct_fact_fft_type = 1; // 0 = gather onto one grid; 1 = distributed slab FFT (FFTW-MPI builds only)
+    struct_fact_fftw_planner = 0; // 0 = FFTW_ESTIMATE; 1 = FFTW_MEASURE; 2 = FFTW_PATIENT
+    struct_fact_fftw_wisdom = ""; // FFTW wisdom file read at startup and updated when plans are measured
     radialdist_int = 0;
     cartdist_int = 0;
     n_steps_skip = 0;
@@ -560,6 +572,7 @@ void InitializeCommonNamespace() {
     poisson_bottom_verbose = 0;
     poisson_max_iter = 100;
     poisson_rel_tol = 1.e-10;
+    poisson_fft = 0; // 0 = multigrid; 1 = FFT (periodic directions and Dirichlet/homogeneous Neumann walls, CPU builds)
 
     particle_grid_refine = 1;
     es_grid_refine = 1;
@@ -579,6 +592,19 @@ void InitializeCommonNamespace() {
     zero_net_force = 0;
 
     // images (no default)
+
+    // es_tog=2: cutoff radius of the neighbor-list pairwise Coulomb force
+    // (0 = all-pairs sum over periodic images) and its damping parameter
+    coulomb_cutoff = 0.;
+    coulomb_damping = 0.;
+
+    // es_tog=3: Ewald splitting parameter of the PPPM mode (0 = Peskin kernel
+    // spreading with the tabulated short-range correction), its real-space
+    // cutoff radius and the B-spline charge assignment order (1-7)
+    p3m_alpha = 0.;
+    p3m_cutoff = 0.;
+    p3m_order = 3;
+
     for (int i=0; i<3; ++i) {
         eamp[i] = 0.;
         efreq[i] = 0.;
@@ -967,6 +993,9 @@ void InitializeCommonNamespace() {
     pp.query("tau_ta",tau_ta);
     pp.query("tau_la",tau_la);
     pp.query("struct_fact_int",struct_fact_int);
+    pp.query("struct_fact_fft_type",struct_fact_fft_type);
+    pp.query("struct_fact_fftw_planner",struct_fact_fftw_planner);
+    pp.query("struct_fact_fftw_wisdom",struct_fact_fftw_wisdom);
     pp.query("radialdist_int",radialdist_int);
     pp.query("cartdist_int",cartdist_int);
     pp.query("n_steps_skip",n_steps_skip);
@@ -1081,6 +1110,7 @@ void InitializeCommonNamespace() {
     pp.query("poisson_bottom_verbose",poisson_bottom_verbose);
     pp.query("poisson_max_iter",poisson_max_iter);
     pp.query("poisson_rel_tol",poisson_rel_tol);
+    pp.query("poisson_fft",poisson_fft);
     pp.query("permittivity",permittivity);
     pp.query("wall_mob",wall_mob);
     pp.query("particle_grid_refine",particle_grid_refine);
@@ -1099,6 +1129,11 @@ void InitializeCommonNamespace() {
     pp.query("zero_net_force",zero_net_force);
     pp.query("crange",crange);
     pp.query("images",images);
+    pp.query("coulomb_cutoff",coulomb_cutoff);
+    pp.query("coulomb_damping",coulomb_damping);
+    pp.query("p3m_alpha",p3m_alpha);
+    pp.query("p3m_cutoff",p3m_cutoff);
+    pp.query("p3m_order",p3m_order);
     pp.queryarr("eamp",eamp,0,3);
     pp.queryarr("efreq",efreq,0,3);
     pp.queryarr("ephase",ephase,0,3);
@@ -1208,11 +1208,28 @@ void setBC(MultiFab& prim_in, MultiFab& cons_in)
     }
 }
 
+// fabs of faceflux owned by mfi, one per face direction
+static std::array<Box,AMREX_SPACEDIM> FaceBoxes(const std::array< MultiFab, AMREX_SPACEDIM >& faceflux,
+                                               const MFIter& mfi)
+{
+    return {AMREX_D_DECL(faceflux[0][mfi].box(),
+                         faceflux[1][mfi].box(),
+                         faceflux[2][mfi].box())};
+}
+
 // set species and total density flux to zero for wall boundary conditions
 void BCWallSpeciesFlux(std::array< MultiFab, AMREX_SPACEDIM >& faceflux, const amrex::Geometry geom)
 {
     BL_PROFILE_VAR("BCWallSpeciesFlux()",BCWallSpeciesFlux);
 
+    for (MFIter mfi(faceflux[0]); mfi.isValid(); ++mfi) {
+        BCWallSpeciesFlux(faceflux, geom, mfi, FaceBoxes(faceflux, mfi));
+    }
+}
+
+void BCWallSpeciesFlux(std::array< MultiFab, AMREX_SPACEDIM >& faceflux, const amrex::Geometry geom,
+                       const MFIter& mfi, const std::array<Box,AMREX_SPACEDIM>& face_bx)
+{
     // LO X
     if (bc_mass_lo[0] == 1) {
 
@@ -1223,23 +1240,21 @@ void BCWallSpeciesFlux(std::array< MultiFab, AMREX_SPACEDIM >& faceflux, const a
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_xlo = amrex::bdryNode(dom_x, Orientation(0, Orientation::low));
 
-        for (MFIter mfi(faceflux[0]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_xlo;
-            Array4<Real> const& flux = (faceflux[0]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) = 0.;
-                    }
-                    // density
-                    flux(i,j,k,0) = 0.;
-                    // Dufour
-                    flux(i,j,k,nvars+3) = 0.;
-                });
-            }
+        const Box& bx = face_bx[0];
+        const Box& b = bx & dom_xlo;
+        Array4<Real> const& flux = (faceflux[0]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) = 0.;
+                }
+                // density
+                flux(i,j,k,0) = 0.;
+                // Dufour
+                flux(i,j,k,nvars+3) = 0.;
+            });
         }
     }
     // HI X
@@ -1252,23 +1267,21 @@ void BCWallSpeciesFlux(std::array< MultiFab, AMREX_SPACEDIM >& faceflux, const a
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_xhi = amrex::bdryNode(dom_x, Orientation(0, Orientation::high));
 
-        for (MFIter mfi(faceflux[0]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_xhi;
-            Array4<Real> const& flux = (faceflux[0]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) = 0.;
-                    }
-                    // density
-                    flux(i,j,k,0) = 0.;
-                    // Dufour
-                    flux(i,j,k,nvars+3) = 0.;
-                });
-            }
+        const Box& bx = face_bx[0];
+        const Box& b = bx & dom_xhi;
+        Array4<Real> const& flux = (faceflux[0]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) = 0.;
+                }
+                // density
+                flux(i,j,k,0) = 0.;
+                // Dufour
+                flux(i,j,k,nvars+3) = 0.;
+            });
         }
     }
     // LO Y
@@ -1281,23 +1294,21 @@ void BCWallSpeciesFlux(std::array< MultiFab, AMREX_SPACEDIM >& faceflux, const a
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_ylo = amrex::bdryNode(dom_y, Orientation(1, Orientation::low));
 
-        for (MFIter mfi(faceflux[1]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_ylo;
-            Array4<Real> const& flux = (faceflux[1]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) = 0.;
-                    }
-                    // density
-                    flux(i,j,k,0) = 0.;
-                    // Dufour
-                    flux(i,j,k,nvars+3) = 0.;
-                });
-            }
+        const Box& bx = face_bx[1];
+        const Box& b = bx & dom_ylo;
+        Array4<Real> const& flux = (faceflux[1]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) = 0.;
+                }
+                // density
+                flux(i,j,k,0) = 0.;
+                // Dufour
+                flux(i,j,k,nvars+3) = 0.;
+            });
         }
     }
     // HI Y 
@@ -1310,23 +1321,21 @@ void BCWallSpeciesFlux(std::array< MultiFab, AMREX_SPACEDIM >& faceflux, const a
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_yhi = amrex::bdryNode(dom_y, Orientation(1, Orientation::high));
 
-        for (MFIter mfi(faceflux[1]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_yhi;
-            Array4<Real> const& flux = (faceflux[1]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) = 0.;
-                    }
-                    // density
-                    flux(i,j,k,0) = 0.;
-                    // Dufour
-                    flux(i,j,k,nvars+3) = 0.;
-                });
-            }
+        const Box& bx = face_bx[1];
+        const Box& b = bx & dom_yhi;
+        Array4<Real> const& flux = (faceflux[1]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) = 0.;
+                }
+                // density
+                flux(i,j,k,0) = 0.;
+                // Dufour
+                flux(i,j,k,nvars+3) = 0.;
+            });
         }
     }
     // LO Z
@@ -1339,23 +1348,21 @@ void BCWallSpeciesFlux(std::array< MultiFab, AMREX_SPACEDIM >& faceflux, const a
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_zlo = amrex::bdryNode(dom_z, Orientation(2, Orientation::low));
 
-        for (MFIter mfi(faceflux[2]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_zlo;
-            Array4<Real> const& flux = (faceflux[2]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) = 0.;
-                    }
-                    // density
-                    flux(i,j,k,0) = 0.;
-                    // Dufour
-                    flux(i,j,k,nvars+3) = 0.;
-                });
-            }
+        const Box& bx = face_bx[2];
+        const Box& b = bx & dom_zlo;
+        Array4<Real> const& flux = (faceflux[2]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) = 0.;
+                }
+                // density
+                flux(i,j,k,0) = 0.;
+                // Dufour
+                flux(i,j,k,nvars+3) = 0.;
+            });
         }
     }
     // HI Z
@@ -1368,33 +1375,38 @@ void BCWallSpeciesFlux(std::array< MultiFab, AMREX_SPACEDIM >& faceflux, const a
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_zhi = amrex::bdryNode(dom_z, Orientation(2, Orientation::high));
 
-        for (MFIter mfi(faceflux[2]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_zhi;
-            Array4<Real> const& flux = (faceflux[2]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) = 0.;
-                    }
-                    // density
-                    flux(i,j,k,0) = 0.;
-                    // Dufour
-                    flux(i,j,k,nvars+3) = 0.;
-                });
-            }
+        const Box& bx = face_bx[2];
+        const Box& b = bx & dom_zhi;
+        Array4<Real> const& flux = (faceflux[2]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) = 0.;
+                }
+                // density
+                flux(i,j,k,0) = 0.;
+                // Dufour
+                flux(i,j,k,nvars+3) = 0.;
+            });
         }
     }
 }
 
 void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
-               const amrex::Geometry geom) {
+               const amrex::Geometry geom)
+{
+    BL_PROFILE_VAR("StochFlux()",StochFlux);
 
+    for (MFIter mfi(faceflux_in[0]); mfi.isValid(); ++mfi) {
+        StochFlux(faceflux_in, geom, mfi, FaceBoxes(faceflux_in, mfi));
+    }
+}
 
-    BL_PROFILE_VAR("StochFlux()",StochFlux);
-    
+void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
+               const amrex::Geometry geom,
+               const MFIter& mfi, const std::array<Box,AMREX_SPACEDIM>& face_bx) {
     // First we do mass boundary conditions (species fluxes reside on faces)
     // LO X
     if (bc_mass_lo[0] == 1 || bc_mass_lo[0] == 2) {
@@ -1410,21 +1422,19 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_xlo = amrex::bdryNode(dom_x, Orientation(0, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[0]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_xlo;
-            Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) *= factor;
-                    }
-                    // Set Dufour as well
-                    flux(i,j,k,nvars+3) *= factor;
-                });
-            }
+        const Box& bx = face_bx[0];
+        const Box& b = bx & dom_xlo;
+        Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) *= factor;
+                }
+                // Set Dufour as well
+                flux(i,j,k,nvars+3) *= factor;
+            });
         }
     }
     // HI X
@@ -1441,21 +1451,19 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_xhi = amrex::bdryNode(dom_x, Orientation(0, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[0]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_xhi;
-            Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) *= factor;
-                    }
-                    // Set Dufour as well
-                    flux(i,j,k,nvars+3) *= factor;
-                });
-            }
+        const Box& bx = face_bx[0];
+        const Box& b = bx & dom_xhi;
+        Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) *= factor;
+                }
+                // Set Dufour as well
+                flux(i,j,k,nvars+3) *= factor;
+            });
         }
     }
     // LO Y
@@ -1472,21 +1480,19 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_ylo = amrex::bdryNode(dom_y, Orientation(1, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[1]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_ylo;
-            Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) *= factor;
-                    }
-                    // Set Dufour as well
-                    flux(i,j,k,nvars+3) *= factor;
-                });
-            }
+        const Box& bx = face_bx[1];
+        const Box& b = bx & dom_ylo;
+        Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) *= factor;
+                }
+                // Set Dufour as well
+                flux(i,j,k,nvars+3) *= factor;
+            });
         }
     }
     // HI Y
@@ -1503,21 +1509,19 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_yhi = amrex::bdryNode(dom_y, Orientation(1, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[1]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_yhi;
-            Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) *= factor;
-                    }
-                    // Set Dufour as well
-                    flux(i,j,k,nvars+3) *= factor;
-                });
-            }
+        const Box& bx = face_bx[1];
+        const Box& b = bx & dom_yhi;
+        Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) *= factor;
+                }
+                // Set Dufour as well
+                flux(i,j,k,nvars+3) *= factor;
+            });
         }
     }
     // LO Z
@@ -1534,21 +1538,19 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_zlo = amrex::bdryNode(dom_z, Orientation(2, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[2]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_zlo;
-            Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) *= factor;
-                    }
-                    // Set Dufour as well
-                    flux(i,j,k,nvars+3) *= factor;
-                });
-            }
+        const Box& bx = face_bx[2];
+        const Box& b = bx & dom_zlo;
+        Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) *= factor;
+                }
+                // Set Dufour as well
+                flux(i,j,k,nvars+3) *= factor;
+            });
         }
     }
     // HI Z
@@ -1565,21 +1567,19 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_zhi = amrex::bdryNode(dom_z, Orientation(2, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[2]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_zhi;
-            Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // species
-                    for (int n=0;n<nspecies;++n) {
-                        flux(i,j,k,n+5) *= factor;
-                    }
-                    // Set Dufour as well
-                    flux(i,j,k,nvars+3) *= factor;
-                });
-            }
+        const Box& bx = face_bx[2];
+        const Box& b = bx & dom_zhi;
+        Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // species
+                for (int n=0;n<nspecies;++n) {
+                    flux(i,j,k,n+5) *= factor;
+                }
+                // Set Dufour as well
+                flux(i,j,k,nvars+3) *= factor;
+            });
         }
     }
 
@@ -1600,17 +1600,15 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_xlo = amrex::bdryNode(dom_x, Orientation(0, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[0]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_xlo;
-            Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // heat flux
-                    flux(i,j,k,nvars) *= factor;
-                });
-            }
+        const Box& bx = face_bx[0];
+        const Box& b = bx & dom_xlo;
+        Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // heat flux
+                flux(i,j,k,nvars) *= factor;
+            });
         }
     }
     // HI X
@@ -1629,17 +1627,15 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_xhi = amrex::bdryNode(dom_x, Orientation(0, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[0]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_xhi;
-            Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // heat flux
-                    flux(i,j,k,nvars) *= factor;
-                });
-            }
+        const Box& bx = face_bx[0];
+        const Box& b = bx & dom_xhi;
+        Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // heat flux
+                flux(i,j,k,nvars) *= factor;
+            });
         }
     }
     // LO Y
@@ -1656,17 +1652,15 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_ylo = amrex::bdryNode(dom_y, Orientation(1, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[1]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_ylo;
-            Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // heat flux
-                    flux(i,j,k,nvars) *= factor;
-                });
-            }
+        const Box& bx = face_bx[1];
+        const Box& b = bx & dom_ylo;
+        Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // heat flux
+                flux(i,j,k,nvars) *= factor;
+            });
         }
     }
     // HI Y
@@ -1683,17 +1677,15 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_yhi = amrex::bdryNode(dom_y, Orientation(1, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[1]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_yhi;
-            Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // heat flux
-                    flux(i,j,k,nvars) *= factor;
-                });
-            }
+        const Box& bx = face_bx[1];
+        const Box& b = bx & dom_yhi;
+        Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // heat flux
+                flux(i,j,k,nvars) *= factor;
+            });
         }
     }
     // LO Z
@@ -1710,17 +1702,15 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_zlo = amrex::bdryNode(dom_z, Orientation(2, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[2]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_zlo;
-            Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    // heat flux
-                    flux(i,j,k,nvars) *= factor;
-                });
-            }
+        const Box& bx = face_bx[2];
+        const Box& b = bx & dom_zlo;
+        Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // heat flux
+                flux(i,j,k,nvars) *= factor;
+            });
         }
     }
     // HI Z
@@ -1737,16 +1727,14 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_zhi = amrex::bdryNode(dom_z, Orientation(2, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[2]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_zhi;
-            Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    flux(i,j,k,nvars) *= factor;
-                });
-            }
+        const Box& bx = face_bx[2];
+        const Box& b = bx & dom_zhi;
+        Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                flux(i,j,k,nvars) *= factor;
+            });
         }
     }
 
@@ -1769,25 +1757,23 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_xlo = amrex::bdryNode(dom_x, Orientation(0, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[0]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_xlo;
-            Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                {
-                    if (n == 0) {
-                        // normal velocity
-                        flux(i,j,k,1+n) *= sqrtTwo;
-                        // viscous heating (diagonal & shear)
-                        flux(i,j,k,nvars+1) *= sqrtTwo;
-                        flux(i,j,k,nvars+2) *= factor;
-                    } else {
-                        // transverse velocity
-                        flux(i,j,k,1+n) *= factor;
-                    }
-                });
-            }
+        const Box& bx = face_bx[0];
+        const Box& b = bx & dom_xlo;
+        Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (n == 0) {
+                    // normal velocity
+                    flux(i,j,k,1+n) *= sqrtTwo;
+                    // viscous heating (diagonal & shear)
+                    flux(i,j,k,nvars+1) *= sqrtTwo;
+                    flux(i,j,k,nvars+2) *= factor;
+                } else {
+                    // transverse velocity
+                    flux(i,j,k,1+n) *= factor;
+                }
+            });
         }
     }
     // HI X
@@ -1805,25 +1791,23 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_xhi = amrex::bdryNode(dom_x, Orientation(0, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[0]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_xhi;
-            Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                {
-                    if (n == 0) {
-                        // normal velocity
-                        flux(i,j,k,1+n) *= sqrtTwo;
-                        // viscous heating (diagonal & shear)
-                        flux(i,j,k,nvars+1) *= sqrtTwo;
-                        flux(i,j,k,nvars+2) *= factor;
-                    } else {
-                        // transverse velocity
-                        flux(i,j,k,1+n) *= factor;
-                    }
-                });
-            }
+        const Box& bx = face_bx[0];
+        const Box& b = bx & dom_xhi;
+        Array4<Real> const& flux = (faceflux_in[0]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (n == 0) {
+                    // normal velocity
+                    flux(i,j,k,1+n) *= sqrtTwo;
+                    // viscous heating (diagonal & shear)
+                    flux(i,j,k,nvars+1) *= sqrtTwo;
+                    flux(i,j,k,nvars+2) *= factor;
+                } else {
+                    // transverse velocity
+                    flux(i,j,k,1+n) *= factor;
+                }
+            });
         }
     }
     // LO Y
@@ -1841,25 +1825,23 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_ylo = amrex::bdryNode(dom_y, Orientation(1, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[1]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_ylo;
-            Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                {
-                    if (n == 1) {
-                        // normal velocity
-                        flux(i,j,k,1+n) *= sqrtTwo;
-                        // viscous heating (diagonal & shear)
-                        flux(i,j,k,nvars+1) *= sqrtTwo;
-                        flux(i,j,k,nvars+2) *= factor;
-                    } else {
-                        // transverse velocity
-                        flux(i,j,k,1+n) *= factor;
-                    }
-                });
-            }
+        const Box& bx = face_bx[1];
+        const Box& b = bx & dom_ylo;
+        Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (n == 1) {
+                    // normal velocity
+                    flux(i,j,k,1+n) *= sqrtTwo;
+                    // viscous heating (diagonal & shear)
+                    flux(i,j,k,nvars+1) *= sqrtTwo;
+                    flux(i,j,k,nvars+2) *= factor;
+                } else {
+                    // transverse velocity
+                    flux(i,j,k,1+n) *= factor;
+                }
+            });
         }
     }
     // HI Y
@@ -1877,25 +1859,23 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_yhi = amrex::bdryNode(dom_y, Orientation(1, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[1]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_yhi;
-            Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                {
-                    if (n == 1) {
-                        // normal velocity
-                        flux(i,j,k,1+n) *= sqrtTwo;
-                        // viscous heating (diagonal & shear)
-                        flux(i,j,k,nvars+1) *= sqrtTwo;
-                        flux(i,j,k,nvars+2) *= factor;
-                    } else {
-                        // transverse velocity
-                        flux(i,j,k,1+n) *= factor;
-                    }
-                });
-            }
+        const Box& bx = face_bx[1];
+        const Box& b = bx & dom_yhi;
+        Array4<Real> const& flux = (faceflux_in[1]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (n == 1) {
+                    // normal velocity
+                    flux(i,j,k,1+n) *= sqrtTwo;
+                    // viscous heating (diagonal & shear)
+                    flux(i,j,k,nvars+1) *= sqrtTwo;
+                    flux(i,j,k,nvars+2) *= factor;
+                } else {
+                    // transverse velocity
+                    flux(i,j,k,1+n) *= factor;
+                }
+            });
         }
     }
     // LO Z
@@ -1913,25 +1893,23 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_zlo = amrex::bdryNode(dom_z, Orientation(2, Orientation::low));
 
-        for (MFIter mfi(faceflux_in[2]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_zlo;
-            Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                {
-                    if (n == 2) {
-                        // normal velocity
-                        flux(i,j,k,1+n) *= sqrtTwo;
-                        // viscous heating (diagonal & shear)
-                        flux(i,j,k,nvars+1) *= sqrtTwo;
-                        flux(i,j,k,nvars+2) *= factor;
-                    } else {
-                        // transverse velocity
-                        flux(i,j,k,1+n) *= factor;
-                    }
-                });
-            }
+        const Box& bx = face_bx[2];
+        const Box& b = bx & dom_zlo;
+        Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (n == 2) {
+                    // normal velocity
+                    flux(i,j,k,1+n) *= sqrtTwo;
+                    // viscous heating (diagonal & shear)
+                    flux(i,j,k,nvars+1) *= sqrtTwo;
+                    flux(i,j,k,nvars+2) *= factor;
+                } else {
+                    // transverse velocity
+                    flux(i,j,k,1+n) *= factor;
+                }
+            });
         }
     }
     // HI Z
@@ -1946,25 +1924,23 @@ void StochFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
         // Orientation(dir,Orientation)  -- Orientation can be ::low or ::high
         const Box& dom_zhi = amrex::bdryNode(dom_z, Orientation(2, Orientation::high));
 
-        for (MFIter mfi(faceflux_in[2]); mfi.isValid(); ++mfi) {
-            const Box& bx = mfi.fabbox();
-            const Box& b = bx & dom_zhi;
-            Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
-            if (b.ok()) {
-                amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                {
-                    if (n == 2) {
-                        // normal velocity
-                        flux(i,j,k,1+n) *= sqrtTwo;
-                        // viscous heating (diagonal & shear)
-                        flux(i,j,k,nvars+1) *= sqrtTwo;
-                        flux(i,j,k,nvars+2) *= factor;
-                    } else {
-                        // transverse velocity
-                        flux(i,j,k,1+n) *= factor;
-                    }
-                });
-            }
+        const Box& bx = face_bx[2];
+        const Box& b = bx & dom_zhi;
+        Array4<Real> const& flux = (faceflux_in[2]).array(mfi);
+        if (b.ok()) {
+            amrex::ParallelFor(b, AMREX_SPACEDIM, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (n == 2) {
+                    // normal velocity
+                    flux(i,j,k,1+n) *= sqrtTwo;
+                    // viscous heating (diagonal & shear)
+                    flux(i,j,k,nvars+1) *= sqrtTwo;
+                    flux(i,j,k,nvars+2) *= factor;
+                } else {
+                    // transverse velocity
+                    flux(i,j,k,1+n) *= factor;
+                }
+            });
         }
     }
 }
@@ -1976,30 +1952,36 @@ void MembraneFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
 
     // Loop over boxes
     for (MFIter mfi(faceflux_in[0]); mfi.isValid(); ++mfi) {
+        MembraneFlux(faceflux_in, geom, mfi, FaceBoxes(faceflux_in, mfi));
+    }
+}
 
-        AMREX_D_TERM(const Array4<Real> & xflux = (faceflux_in[0]).array(mfi);,
-                     const Array4<Real> & yflux = (faceflux_in[1]).array(mfi);,
-                     const Array4<Real> & zflux = (faceflux_in[2]).array(mfi););
+void MembraneFlux(std::array<MultiFab, AMREX_SPACEDIM>& faceflux_in,
+                  const amrex::Geometry geom,
+                  const MFIter& mfi, const std::array<Box,AMREX_SPACEDIM>& face_bx) {
 
-        // since the MFIter is built on a nodal MultiFab we need to build the
-        // nodal tileboxes for each direction in this way
-        AMREX_D_TERM(Box bx_x = mfi.tilebox(nodal_flag_x);,
-                     Box bx_y = mfi.tilebox(nodal_flag_y);,
-                     Box bx_z = mfi.tilebox(nodal_flag_z););
+    AMREX_D_TERM(const Array4<Real> & xflux = (faceflux_in[0]).array(mfi);,
+                 const Array4<Real> & yflux = (faceflux_in[1]).array(mfi);,
+                 const Array4<Real> & zflux = (faceflux_in[2]).array(mfi););
 
-        if (bx_x.smallEnd(0) == membrane_cell || bx_x.bigEnd(0) == membrane_cell) {
+    const Box& bx_x = face_bx[0];
 
-            amrex::ParallelFor(bx_x, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+    // the membrane sits on a grid boundary, so test the faces of the valid box
+    // (not of the tile, which may end at membrane_cell in the interior of a grid)
+    const Box& vbx_x = amrex::convert(mfi.validbox(), faceflux_in[0].ixType());
 
-                if (i == membrane_cell) {
-                    xflux(i,j,k,1) = 0.;
-                    xflux(i,j,k,2) = 0.;
-                    xflux(i,j,k,3) = 0.;
-                    xflux(i,j,k,4) = 0.;
-                }
+    if (vbx_x.smallEnd(0) == membrane_cell || vbx_x.bigEnd(0) == membrane_cell) {
+
+        amrex::ParallelFor(bx_x, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+
+            if (i == membrane_cell) {
+                xflux(i,j,k,1) = 0.;
+                xflux(i,j,k,2) = 0.;
+                xflux(i,j,k,3) = 0.;
+                xflux(i,j,k,4) = 0.;
+            }
                     
-             });
+         });
             
-        }
     }
 }
@@ -7,6 +7,9 @@ AMREX_GPU_MANAGED amrex::GpuArray<amrex::Real, MAX_SPECIES> compressible::transm
 AMREX_GPU_MANAGED int compressible::do_1D;
 AMREX_GPU_MANAGED int compressible::do_2D;
 AMREX_GPU_MANAGED int compressible::all_correl;
+AMREX_GPU_MANAGED int compressible::fused_flux;
+AMREX_GPU_MANAGED amrex::Real compressible::transport_coeff_tol;
+AMREX_GPU_MANAGED int compressible::transport_coeff_check_int;
 
 void InitializeCompressibleNamespace()
 {
@@ -61,6 +64,20 @@ void InitializeCompressibleNamespace()
     all_correl = 0;
     pp.query("all_correl",all_correl);
 
+    // compute all flux stages tile by tile (1) or each stage over all boxes (0)
+    fused_flux = 0;
+    pp.query("fused_flux",fused_flux);
+
+    // only recompute transport coefficients in cells where rho, T, p (relative)
+    // or Yk (absolute) changed by more than this since the last evaluation
+    // (0 = always recompute)
+    transport_coeff_tol = 0.;
+    pp.query("transport_coeff_tol",transport_coeff_tol);
+
+    // report the error of the cached transport coefficients every this many steps
+    transport_coeff_check_int = 0;
+    pp.query("transport_coeff_check_int",transport_coeff_check_int);
+
 
     return;
 }
@@ -1,10 +1,10 @@
 #include "common_functions.H"
 #include "compressible_functions.H"
 
-void conservedToPrimitive(MultiFab& prim_in, const MultiFab& cons_in)
+// instantiated for NS species by conservedToPrimitive (NS = 0 is generic)
+template <int NS>
+static void conservedToPrimitiveNS(MultiFab& prim_in, const MultiFab& cons_in)
 {
-    BL_PROFILE_VAR("conservedToPrimitive()",conservedToPrimitive);
-
     // from namelist
     /* 
     // method 1 to create a thread shared array
@@ -47,6 +47,8 @@ void conservedToPrimitive(MultiFab& prim_in, const MultiFab& cons_in)
 
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
+
             // method 2 to create a thread private array
             // can use when the size of the array is known at compile-time
             GpuArray<Real,MAX_SPECIES> Xk;
@@ -74,10 +76,10 @@ void conservedToPrimitive(MultiFab& prim_in, const MultiFab& cons_in)
             }
 
             // update temperature in-place using internal energy
-            GetTemperature(intenergy, Yk_fixed, prim(i,j,k,4));
+            GetTemperature<NS>(intenergy, Yk_fixed, prim(i,j,k,4));
 
             // compute mole fractions from mass fractions
-            GetMolfrac(Yk, Xk);
+            GetMolfrac<NS>(Yk, Xk);
 
             // mass fractions
             for (int n=0; n<nspecies; ++n) {
@@ -85,8 +87,15 @@ void conservedToPrimitive(MultiFab& prim_in, const MultiFab& cons_in)
                 prim(i,j,k,6+nspecies+n) = Xk[n];
             }
 
-            GetPressureGas(prim(i,j,k,5), Yk, prim(i,j,k,0), prim(i,j,k,4));
+            GetPressureGas<NS>(prim(i,j,k,5), Yk, prim(i,j,k,0), prim(i,j,k,4));
         });
         
     } // end MFIter
 }
+
+void conservedToPrimitive(MultiFab& prim_in, const MultiFab& cons_in)
+{
+    BL_PROFILE_VAR("conservedToPrimitive()",conservedToPrimitive);
+
+    NSPECIES_DISPATCH(conservedToPrimitiveNS, prim_in, cons_in);
+}
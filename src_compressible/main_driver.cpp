@@ -1,5 +1,6 @@
 #include "common_functions.H"
 #include "compressible_functions.H"
+#include "RK3Integrator.H"
 
 
 #include "rng_functions.H"
@@ -142,6 +143,17 @@ void main_driver(const char* argv)
 
     }
 
+    // key for the counter-based noise in RK3Integrator; with a fixed seed the noise
+    // only depends on (seed, step) and is reproduced after a restart
+    if (seed > 0) {
+        InitRandomNoise(seed);
+    } else {
+        auto now = time_point_cast<nanoseconds>(system_clock::now());
+        int randSeed = now.time_since_epoch().count();
+        ParallelDescriptor::Bcast(&randSeed,1,ParallelDescriptor::IOProcessorNumber());
+        InitRandomNoise(static_cast<unsigned int>(randSeed));
+    }
+
     /////////////////////////////////////////
 
     // transport properties
@@ -623,6 +635,9 @@ void main_driver(const char* argv)
     mui_announce_send_recv_span(uniface,cu,dx);
 #endif
 
+    // integrator owns the white noise work fields for the whole run
+    RK3Integrator integrator(prim, stochFlux, rancorn, ranchem);
+
     //Time stepping loop
     for(step=1;step<=max_step;++step) {
 
@@ -641,8 +656,8 @@ void main_driver(const char* argv)
         if (ads_spec>=0) sample_MFsurfchem(cu, prim, surfcov, dNadsdes, dx, dt);
 
         // FHD
-        RK3step(cu, cup, cup2, cup3, prim, source, eta, zeta, kappa, chi, D, flux,
-                stochFlux, cornx, corny, cornz, visccorn, rancorn, ranchem, geom, dt);
+        integrator.Step(cu, cup, cup2, cup3, prim, source, eta, zeta, kappa, chi, D, flux,
+                        stochFlux, cornx, corny, cornz, visccorn, rancorn, ranchem, geom, dt, step);
 
         // update surface chemistry (via either surfchem_mui or MFsurfchem)
 #ifdef MUI
@@ -6,21 +6,54 @@
 
 #include "rng_functions.H"
 
+#include "RK3Integrator.H"
 
 
-void RK3step(MultiFab& cu, MultiFab& cup, MultiFab& cup2, MultiFab& cup3,
-             MultiFab& prim, MultiFab& source,
-             MultiFab& eta, MultiFab& zeta, MultiFab& kappa,
-             MultiFab& chi, MultiFab& D,
-             std::array<MultiFab, AMREX_SPACEDIM>& flux,
-             std::array<MultiFab, AMREX_SPACEDIM>& stochFlux,
-             std::array<MultiFab, AMREX_SPACEDIM>& cornx,
-             std::array<MultiFab, AMREX_SPACEDIM>& corny,
-             std::array<MultiFab, AMREX_SPACEDIM>& cornz,
-             MultiFab& visccorn, MultiFab& rancorn, MultiFab& ranchem,
-             const amrex::Geometry geom, const amrex::Real dt)
+
+RK3Integrator::RK3Integrator (const MultiFab& prim,
+                              const std::array<MultiFab, AMREX_SPACEDIM>& stochFlux,
+                              const MultiFab& rancorn, const MultiFab& ranchem)
 {
-    BL_PROFILE_VAR("RK3step()",RK3step);
+    BL_PROFILE_VAR("RK3Integrator::RK3Integrator()",RK3Integrator_ctor);
+
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        stochFlux_A[d].define(stochFlux[d].boxArray(), stochFlux[d].DistributionMap(), nvars, 0);
+        stochFlux_B[d].define(stochFlux[d].boxArray(), stochFlux[d].DistributionMap(), nvars, 0);
+        // density component 0 is never filled
+        stochFlux_A[d].setVal(0.0);
+        stochFlux_B[d].setVal(0.0);
+    }
+
+    rancorn_A.define(rancorn.boxArray(), rancorn.DistributionMap(), 1, 0);
+    rancorn_B.define(rancorn.boxArray(), rancorn.DistributionMap(), 1, 0);
+
+    // chemistry
+    if (nreaction>0)
+    {
+        ranchem_A.define(ranchem.boxArray(), ranchem.DistributionMap(), nreaction, 0);
+        ranchem_B.define(ranchem.boxArray(), ranchem.DistributionMap(), nreaction, 0);
+    }
+
+    // transport coefficient cache; T<0 forces a full evaluation on the first call
+    if (transport_coeff_tol > 0.) {
+        prim_last.define(prim.boxArray(), prim.DistributionMap(), 3+nspecies, ngc);
+        prim_last.setVal(-1.0);
+    }
+}
+
+void RK3Integrator::Step(MultiFab& cu, MultiFab& cup, MultiFab& cup2, MultiFab& cup3,
+                         MultiFab& prim, MultiFab& source,
+                         MultiFab& eta, MultiFab& zeta, MultiFab& kappa,
+                         MultiFab& chi, MultiFab& D,
+                         std::array<MultiFab, AMREX_SPACEDIM>& flux,
+                         std::array<MultiFab, AMREX_SPACEDIM>& stochFlux,
+                         std::array<MultiFab, AMREX_SPACEDIM>& cornx,
+                         std::array<MultiFab, AMREX_SPACEDIM>& corny,
+                         std::array<MultiFab, AMREX_SPACEDIM>& cornz,
+                         MultiFab& visccorn, MultiFab& rancorn, MultiFab& ranchem,
+                         const amrex::Geometry geom, const amrex::Real dt, const int step)
+{
+    BL_PROFILE_VAR("RK3Integrator::Step()",RK3Integrator_Step);
     
     const GpuArray<Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
     
@@ -32,75 +65,45 @@ void RK3step(MultiFab& cu, MultiFab& cup, MultiFab& cup2, MultiFab& cup3,
     amrex::Real swgt1, swgt2;
     swgt1 = 1.0;
 
-    // Temp. stoch. fluxes
-
-    // field "A"
-    std::array< MultiFab, AMREX_SPACEDIM > stochFlux_A;
-    AMREX_D_TERM(stochFlux_A[0].define(stochFlux[0].boxArray(), stochFlux[0].DistributionMap(), nvars, 0);,
-                 stochFlux_A[1].define(stochFlux[1].boxArray(), stochFlux[1].DistributionMap(), nvars, 0);,
-                 stochFlux_A[2].define(stochFlux[2].boxArray(), stochFlux[2].DistributionMap(), nvars, 0););
-
-    MultiFab rancorn_A;
-    rancorn_A.define(rancorn.boxArray(), rancorn.DistributionMap(), 1, 0);
-
-    // field "B"
-    std::array< MultiFab, AMREX_SPACEDIM > stochFlux_B;
-    AMREX_D_TERM(stochFlux_B[0].define(stochFlux[0].boxArray(), stochFlux[0].DistributionMap(), nvars, 0);,
-                 stochFlux_B[1].define(stochFlux[1].boxArray(), stochFlux[1].DistributionMap(), nvars, 0);,
-                 stochFlux_B[2].define(stochFlux[2].boxArray(), stochFlux[2].DistributionMap(), nvars, 0););
-
-    MultiFab rancorn_B;
-    rancorn_B.define(rancorn.boxArray(), rancorn.DistributionMap(), 1, 0);
-
-    AMREX_D_TERM(stochFlux_A[0].setVal(0.0);,
-                 stochFlux_A[1].setVal(0.0);,
-                 stochFlux_A[2].setVal(0.0););
-    rancorn_A.setVal(0.0);
-
-    AMREX_D_TERM(stochFlux_B[0].setVal(0.0);,
-                 stochFlux_B[1].setVal(0.0);,
-                 stochFlux_B[2].setVal(0.0););
-    rancorn_B.setVal(0.0);
-
-    // chemistry
-    MultiFab ranchem_A;
-    MultiFab ranchem_B;
-    if (nreaction>0)
-    {
-        ranchem_A.define(ranchem.boxArray(), ranchem.DistributionMap(), nreaction, 0);
-        ranchem_B.define(ranchem.boxArray(), ranchem.DistributionMap(), nreaction, 0);
+    // fill random numbers (can skip density component 0)
+    // each field gets its own stream of the counter-based generator so the
+    // samples only depend on (seed, step, field, component, global index)
+    Vector<Real> variance(nvars-1);
+    for(int i=1;i<nvars;i++) {
+        Real var;
+        if (i>=1 && i <= 3) {
+            var = variance_coef_mom;
+        } else if (i == 4) {
+            var = variance_coef_ener;
+        } else {
+            var = variance_coef_mass;
+        }
+        variance[i-1] = var*var;
     }
 
-    // fill random numbers (can skip density component 0)
     for(int d=0;d<AMREX_SPACEDIM;d++) {
-    	for(int i=1;i<nvars;i++) {
-            Real variance;
-            if (i>=1 && i <= 3) {
-                variance = variance_coef_mom;
-            } else if (i == 4) {
-                variance = variance_coef_ener;
-            } else {
-                variance = variance_coef_mass;
-            }
-            MultiFabFillRandom(stochFlux_A[d], i, variance*variance, geom);
-            MultiFabFillRandom(stochFlux_B[d], i, variance*variance, geom);
-        }
+        MultiFabFillRandomNormal(stochFlux_A[d], 1, nvars-1, variance, geom, step, d);
+        MultiFabFillRandomNormal(stochFlux_B[d], 1, nvars-1, variance, geom, step, AMREX_SPACEDIM+d);
     }
 
-    MultiFabFillRandom(rancorn_A, 0, variance_coef_mom*variance_coef_mom, geom);
-    MultiFabFillRandom(rancorn_B, 0, variance_coef_mom*variance_coef_mom, geom);
+    Vector<Real> variance_corn(1, variance_coef_mom*variance_coef_mom);
+    MultiFabFillRandomNormal(rancorn_A, 0, 1, variance_corn, geom, step, 2*AMREX_SPACEDIM);
+    MultiFabFillRandomNormal(rancorn_B, 0, 1, variance_corn, geom, step, 2*AMREX_SPACEDIM+1);
 
     if (nreaction>0) {
-        for (int m=0;m<nreaction;m++) {
-            MultiFabFillRandom(ranchem_A, m, 1.0, geom);
-            MultiFabFillRandom(ranchem_B, m, 1.0, geom);
-        }
+        Vector<Real> variance_chem(nreaction, 1.0);
+        MultiFabFillRandomNormal(ranchem_A, 0, nreaction, variance_chem, geom, step, 2*AMREX_SPACEDIM+2);
+        MultiFabFillRandomNormal(ranchem_B, 0, nreaction, variance_chem, geom, step, 2*AMREX_SPACEDIM+3);
     }
 
     /////////////////////////////////////////////////////
 
     // Compute transport coefs after setting BCs    
-    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D);
+    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D, &prim_last);
+
+    if (transport_coeff_tol > 0. && transport_coeff_check_int > 0 && step%transport_coeff_check_int == 0) {
+        TransportCoeffsError(prim, eta, zeta, kappa, chi, D);
+    }
 
     ///////////////////////////////////////////////////////////
     // Perform weighting of white noise fields
@@ -208,7 +211,7 @@ void RK3step(MultiFab& cu, MultiFab& cup, MultiFab& cup2, MultiFab& cup3,
     setBC(prim, cup);
 
     // Compute transport coefs after setting BCs
-    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D);
+    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D, &prim_last);
 
     ///////////////////////////////////////////////////////////
     // Perform weighting of white noise fields
@@ -312,7 +315,7 @@ void RK3step(MultiFab& cu, MultiFab& cup, MultiFab& cup2, MultiFab& cup3,
     setBC(prim, cup2);
 
     // Compute transport coefs after setting BCs
-    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D);
+    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D, &prim_last);
 
     ///////////////////////////////////////////////////////////
     // Perform weighting of white noise fields
@@ -4,11 +4,20 @@
 using namespace common;
 using namespace compressible;
 
-void calculateTransportCoeffs(const MultiFab& prim_in, 
-			      MultiFab& eta_in, MultiFab& zeta_in, MultiFab& kappa_in,
-			      MultiFab& chi_in, MultiFab& Dij_in)
+// instantiated for NS species by calculateTransportCoeffs (NS = 0 is generic)
+template <int NS>
+static void calculateTransportCoeffsNS(const MultiFab& prim_in,
+                                       MultiFab& eta_in, MultiFab& zeta_in, MultiFab& kappa_in,
+                                       MultiFab& chi_in, MultiFab& Dij_in,
+                                       MultiFab* prim_last_in)
 {
-    BL_PROFILE_VAR("calculateTransportCoeffs()",calculateTransportCoeffs);
+    // with transport_coeff_tol > 0 and a state cache, only recompute the
+    // coefficients in cells where rho, T or p changed by more than the relative
+    // tolerance, or any mass fraction by more than the absolute tolerance, since
+    // the coefficients there were last evaluated
+    // the cache holds (rho, T, p, Y_1..Y_nspecies) at the last evaluation
+    const bool use_cache = (prim_last_in != nullptr) && (transport_coeff_tol > 0.);
+    const Real tol = transport_coeff_tol;
 
     // see comments in conservedPrimitiveConversions.cpp regarding alternate ways of declaring
     // thread shared and thread private arrays on GPUs
@@ -29,8 +38,28 @@ void calculateTransportCoeffs(const MultiFab& prim_in,
         const Array4<Real>& chi   =   chi_in.array(mfi);
         const Array4<Real>& Dij   =   Dij_in.array(mfi);
 
+        const Array4<Real>& prim_last = use_cache ? prim_last_in->array(mfi) : Array4<Real>{};
+
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
+
+            if (use_cache) {
+                bool changed = (amrex::Math::abs(prim(i,j,k,0) - prim_last(i,j,k,0)) > tol*prim_last(i,j,k,0))
+                            || (amrex::Math::abs(prim(i,j,k,4) - prim_last(i,j,k,1)) > tol*prim_last(i,j,k,1))
+                            || (amrex::Math::abs(prim(i,j,k,5) - prim_last(i,j,k,2)) > tol*prim_last(i,j,k,2));
+                for (int n=0; n<nspecies; ++n) {
+                    changed = changed || (amrex::Math::abs(prim(i,j,k,6+n) - prim_last(i,j,k,3+n)) > tol);
+                }
+                if (!changed) return;
+
+                prim_last(i,j,k,0) = prim(i,j,k,0);
+                prim_last(i,j,k,1) = prim(i,j,k,4);
+                prim_last(i,j,k,2) = prim(i,j,k,5);
+                for (int n=0; n<nspecies; ++n) {
+                    prim_last(i,j,k,3+n) = prim(i,j,k,6+n);
+                }
+            }
         
             GpuArray<Real,MAX_SPECIES> Yk_fixed;
             GpuArray<Real,MAX_SPECIES> Xk_fixed;
@@ -48,16 +77,16 @@ void calculateTransportCoeffs(const MultiFab& prim_in,
             }
 
             // compute mole fractions from mass fractions
-            GetMolfrac(Yk_fixed, Xk_fixed);
+            GetMolfrac<NS>(Yk_fixed, Xk_fixed);
 
             if (transport_type == 1) { // Giovangigli
-                IdealMixtureTransportGIO(i,j,k, prim(i,j,k,0), prim(i,j,k,4), prim(i,j,k,5),
+                IdealMixtureTransportGIO<NS>(i,j,k, prim(i,j,k,0), prim(i,j,k,4), prim(i,j,k,5),
                                          Yk_fixed, eta(i,j,k), kappa(i,j,k), zeta(i,j,k),
                                          Dij, chi);
             }
 
             else if (transport_type == 2) { // Waldmann-Valk
-                IdealMixtureTransportVW(i,j,k, prim(i,j,k,0), prim(i,j,k,4), prim(i,j,k,5),
+                IdealMixtureTransportVW<NS>(i,j,k, prim(i,j,k,0), prim(i,j,k,4), prim(i,j,k,5),
                                       Yk_fixed, Xk_fixed, eta(i,j,k), kappa(i,j,k), zeta(i,j,k),
                                       Dij, chi);
             }
@@ -78,3 +107,55 @@ void calculateTransportCoeffs(const MultiFab& prim_in,
         });
     }
 }
+
+void calculateTransportCoeffs(const MultiFab& prim_in,
+			      MultiFab& eta_in, MultiFab& zeta_in, MultiFab& kappa_in,
+			      MultiFab& chi_in, MultiFab& Dij_in,
+                              MultiFab* prim_last_in)
+{
+    BL_PROFILE_VAR("calculateTransportCoeffs()",calculateTransportCoeffs);
+
+    NSPECIES_DISPATCH(calculateTransportCoeffsNS, prim_in, eta_in, zeta_in, kappa_in,
+                      chi_in, Dij_in, prim_last_in);
+}
+
+void TransportCoeffsError(const MultiFab& prim_in,
+                          const MultiFab& eta_in, const MultiFab& zeta_in, const MultiFab& kappa_in,
+                          const MultiFab& chi_in, const MultiFab& Dij_in)
+{
+    BL_PROFILE_VAR("TransportCoeffsError()",TransportCoeffsError);
+
+    const BoxArray& ba = prim_in.boxArray();
+    const DistributionMapping& dmap = prim_in.DistributionMap();
+
+    // coefficients from a full evaluation of the transport model
+    MultiFab eta  (ba, dmap, 1, ngc);
+    MultiFab zeta (ba, dmap, 1, ngc);
+    MultiFab kappa(ba, dmap, 1, ngc);
+    MultiFab chi  (ba, dmap, nspecies, ngc);
+    MultiFab Dij  (ba, dmap, nspecies*nspecies, ngc);
+
+    calculateTransportCoeffs(prim_in, eta, zeta, kappa, chi, Dij);
+
+    // max relative error over the valid region
+    auto relerr = [] (const MultiFab& approx, MultiFab& exact) {
+        int ncomp = exact.nComp();
+        Real scale = exact.norm0(0,ncomp,0);
+        MultiFab::Subtract(exact, approx, 0, 0, ncomp, 0);
+        Real err = exact.norm0(0,ncomp,0);
+        return (scale > 0.) ? err/scale : err;
+    };
+
+    Real err_eta   = relerr(eta_in, eta);
+    Real err_zeta  = relerr(zeta_in, zeta);
+    Real err_kappa = relerr(kappa_in, kappa);
+    Real err_chi   = relerr(chi_in, chi);
+    Real err_Dij   = relerr(Dij_in, Dij);
+
+    Print() << "Transport coefficient cache relative error:"
+            << " eta " << err_eta
+            << " zeta " << err_zeta
+            << " kappa " << err_kappa
+            << " chi " << err_chi
+            << " Dij " << err_Dij << "\n";
+}
@@ -4,40 +4,99 @@
 #include "common_functions.H"
 
 #include "rng_functions.H"
+
+#include "RK3IntegratorStag.H"
 #include <AMReX_VisMF.H>
 
-void RK3stepStag(MultiFab& cu, 
-                 std::array< MultiFab, AMREX_SPACEDIM >& cumom,
-                 MultiFab& prim, std::array< MultiFab, AMREX_SPACEDIM >& vel,
-                 MultiFab& source,
-                 MultiFab& eta, MultiFab& zeta, MultiFab& kappa,
-                 MultiFab& chi, MultiFab& D,
-                 std::array<MultiFab, AMREX_SPACEDIM>& faceflux,
-                 std::array< MultiFab, 2 >& edgeflux_x,
-                 std::array< MultiFab, 2 >& edgeflux_y,
-                 std::array< MultiFab, 2 >& edgeflux_z,
-                 std::array< MultiFab, AMREX_SPACEDIM>& cenflux,
-                 const amrex::Geometry geom, const amrex::Real dt, const int step)
+RK3IntegratorStag::RK3IntegratorStag (const BoxArray& ba, const DistributionMapping& dmap)
 {
-    BL_PROFILE_VAR("RK3stepStag()",RK3stepStag);
+    BL_PROFILE_VAR("RK3IntegratorStag::RK3IntegratorStag()",RK3IntegratorStag_ctor);
+
+    cup .define(ba,dmap,nvars,ngc);
+    cup2.define(ba,dmap,nvars,ngc);
+
+    AMREX_D_TERM(cupmom[0].define(convert(ba,nodal_flag_x), dmap, 1, ngc);,
+                 cupmom[1].define(convert(ba,nodal_flag_y), dmap, 1, ngc);,
+                 cupmom[2].define(convert(ba,nodal_flag_z), dmap, 1, ngc););
+
+    AMREX_D_TERM(cup2mom[0].define(convert(ba,nodal_flag_x), dmap, 1, ngc);,
+                 cup2mom[1].define(convert(ba,nodal_flag_y), dmap, 1, ngc);,
+                 cup2mom[2].define(convert(ba,nodal_flag_z), dmap, 1, ngc););
+
+    /////////////////////////////////////////////////////
+    // Setup stochastic flux MultiFabs
+    AMREX_D_TERM(stochface[0].define(convert(ba,nodal_flag_x), dmap, nvars, 0);,
+                 stochface[1].define(convert(ba,nodal_flag_y), dmap, nvars, 0);,
+                 stochface[2].define(convert(ba,nodal_flag_z), dmap, nvars, 0););
+
+    stochedge_x[0].define(convert(ba,nodal_flag_xy), dmap, 1, 0);
+    stochedge_x[1].define(convert(ba,nodal_flag_xz), dmap, 1, 0);
+
+    stochedge_y[0].define(convert(ba,nodal_flag_xy), dmap, 1, 0);
+    stochedge_y[1].define(convert(ba,nodal_flag_yz), dmap, 1, 0);
+
+    stochedge_z[0].define(convert(ba,nodal_flag_xz), dmap, 1, 0);
+    stochedge_z[1].define(convert(ba,nodal_flag_yz), dmap, 1, 0);
+
+    AMREX_D_TERM(stochcen[0].define(ba,dmap,1,1);,
+                 stochcen[1].define(ba,dmap,1,1);,
+                 stochcen[2].define(ba,dmap,1,1););
+
+    /////////////////////////////////////////////////////
+    // white noise fields; components that are not filled for the current
+    // dimensionality (and density component 0) stay zero for the whole run
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        stochface_A[d].define(stochface[d].boxArray(), dmap, nvars, 0);
+        stochface_B[d].define(stochface[d].boxArray(), dmap, nvars, 0);
+        stochface_A[d].setVal(0.0);
+        stochface_B[d].setVal(0.0);
+
+        stochcen_A[d].define(ba,dmap,1,1);
+        stochcen_B[d].define(ba,dmap,1,1);
+        stochcen_A[d].setVal(0.0);
+        stochcen_B[d].setVal(0.0);
+    }
+
+    for (int i=0; i<2; ++i) {
+        stochedge_x_A[i].define(stochedge_x[i].boxArray(), dmap, 1, 0);
+        stochedge_y_A[i].define(stochedge_y[i].boxArray(), dmap, 1, 0);
+        stochedge_z_A[i].define(stochedge_z[i].boxArray(), dmap, 1, 0);
+        stochedge_x_B[i].define(stochedge_x[i].boxArray(), dmap, 1, 0);
+        stochedge_y_B[i].define(stochedge_y[i].boxArray(), dmap, 1, 0);
+        stochedge_z_B[i].define(stochedge_z[i].boxArray(), dmap, 1, 0);
+
+        stochedge_x_A[i].setVal(0.0); stochedge_x_B[i].setVal(0.0);
+        stochedge_y_A[i].setVal(0.0); stochedge_y_B[i].setVal(0.0);
+        stochedge_z_A[i].setVal(0.0); stochedge_z_B[i].setVal(0.0);
+    }
+
+    // transport coefficient cache; T<0 forces a full evaluation on the first call
+    if (transport_coeff_tol > 0.) {
+        prim_last.define(ba,dmap,3+nspecies,ngc);
+        prim_last.setVal(-1.0);
+    }
+}
+
+void RK3IntegratorStag::Step(MultiFab& cu, 
+                             std::array< MultiFab, AMREX_SPACEDIM >& cumom,
+                             MultiFab& prim, std::array< MultiFab, AMREX_SPACEDIM >& vel,
+                             MultiFab& source,
+                             MultiFab& eta, MultiFab& zeta, MultiFab& kappa,
+                             MultiFab& chi, MultiFab& D,
+                             std::array<MultiFab, AMREX_SPACEDIM>& faceflux,
+                             std::array< MultiFab, 2 >& edgeflux_x,
+                             std::array< MultiFab, 2 >& edgeflux_y,
+                             std::array< MultiFab, 2 >& edgeflux_z,
+                             std::array< MultiFab, AMREX_SPACEDIM>& cenflux,
+                             const amrex::Geometry geom, const amrex::Real dt, const int step)
+{
+    BL_PROFILE_VAR("RK3IntegratorStag::Step()",RK3IntegratorStag_Step);
 
-    MultiFab cup (cu.boxArray(),cu.DistributionMap(),nvars,ngc);
-    MultiFab cup2(cu.boxArray(),cu.DistributionMap(),nvars,ngc);
     cup.setVal(0.0,0,nvars,ngc);
     cup2.setVal(0.0,0,nvars,ngc);
     //cup.setVal(rho0,0,1,ngc);
     //cup2.setVal(rho0,0,1,ngc);
 
-    std::array< MultiFab, AMREX_SPACEDIM > cupmom;
-    std::array< MultiFab, AMREX_SPACEDIM > cup2mom;
-    AMREX_D_TERM(cupmom[0].define(convert(cu.boxArray(),nodal_flag_x), cu.DistributionMap(), 1, ngc);,
-                 cupmom[1].define(convert(cu.boxArray(),nodal_flag_y), cu.DistributionMap(), 1, ngc);,
-                 cupmom[2].define(convert(cu.boxArray(),nodal_flag_z), cu.DistributionMap(), 1, ngc););
-
-    AMREX_D_TERM(cup2mom[0].define(convert(cu.boxArray(),nodal_flag_x), cu.DistributionMap(), 1, ngc);,
-                 cup2mom[1].define(convert(cu.boxArray(),nodal_flag_y), cu.DistributionMap(), 1, ngc);,
-                 cup2mom[2].define(convert(cu.boxArray(),nodal_flag_z), cu.DistributionMap(), 1, ngc););
-    
     AMREX_D_TERM(cupmom[0].setVal(0.0);,
                  cupmom[1].setVal(0.0);,
                  cupmom[2].setVal(0.0););
@@ -48,32 +107,6 @@ void RK3stepStag(MultiFab& cu,
 
     const GpuArray<Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
     
-    /////////////////////////////////////////////////////
-    // Setup stochastic flux MultiFabs
-    std::array< MultiFab, AMREX_SPACEDIM > stochface;
-    AMREX_D_TERM(stochface[0].define(convert(cu.boxArray(),nodal_flag_x), cu.DistributionMap(), nvars, 0);,
-                 stochface[1].define(convert(cu.boxArray(),nodal_flag_y), cu.DistributionMap(), nvars, 0);,
-                 stochface[2].define(convert(cu.boxArray(),nodal_flag_z), cu.DistributionMap(), nvars, 0););
-    
-    std::array< MultiFab, 2 > stochedge_x; 
-    std::array< MultiFab, 2 > stochedge_y; 
-    std::array< MultiFab, 2 > stochedge_z; 
-
-    stochedge_x[0].define(convert(cu.boxArray(),nodal_flag_xy), cu.DistributionMap(), 1, 0); 
-    stochedge_x[1].define(convert(cu.boxArray(),nodal_flag_xz), cu.DistributionMap(), 1, 0);
-             
-    stochedge_y[0].define(convert(cu.boxArray(),nodal_flag_xy), cu.DistributionMap(), 1, 0);
-    stochedge_y[1].define(convert(cu.boxArray(),nodal_flag_yz), cu.DistributionMap(), 1, 0);
-
-    stochedge_z[0].define(convert(cu.boxArray(),nodal_flag_xz), cu.DistributionMap(), 1, 0);
-    stochedge_z[1].define(convert(cu.boxArray(),nodal_flag_yz), cu.DistributionMap(), 1, 0);
-
-    std::array< MultiFab, AMREX_SPACEDIM > stochcen;
-    AMREX_D_TERM(stochcen[0].define(cu.boxArray(),cu.DistributionMap(),1,1);,
-                 stochcen[1].define(cu.boxArray(),cu.DistributionMap(),1,1);,
-                 stochcen[2].define(cu.boxArray(),cu.DistributionMap(),1,1););
-    /////////////////////////////////////////////////////
-
     /////////////////////////////////////////////////////
     // Initialize white noise weighted fields
     // weights for stochastic fluxes; swgt2 changes each stage
@@ -81,78 +114,6 @@ void RK3stepStag(MultiFab& cu,
     amrex::Real swgt1, swgt2;
     swgt1 = 1.0;
 
-    // field "A"
-    std::array< MultiFab, AMREX_SPACEDIM > stochface_A;
-    AMREX_D_TERM(stochface_A[0].define(stochface[0].boxArray(), stochface[0].DistributionMap(), nvars, 0);,
-                 stochface_A[1].define(stochface[1].boxArray(), stochface[1].DistributionMap(), nvars, 0);,
-                 stochface_A[2].define(stochface[2].boxArray(), stochface[2].DistributionMap(), nvars, 0););
-
-    AMREX_D_TERM(stochface_A[0].setVal(0.0);,
-                 stochface_A[1].setVal(0.0);,
-                 stochface_A[2].setVal(0.0););
-    
-    std::array< MultiFab, 2 > stochedge_x_A; 
-    std::array< MultiFab, 2 > stochedge_y_A; 
-    std::array< MultiFab, 2 > stochedge_z_A; 
-
-    stochedge_x_A[0].define(stochedge_x[0].boxArray(), stochedge_x[0].DistributionMap(), 1, 0); 
-    stochedge_x_A[1].define(stochedge_x[1].boxArray(), stochedge_x[1].DistributionMap(), 1, 0);
-             
-    stochedge_y_A[0].define(stochedge_y[0].boxArray(), stochedge_y[0].DistributionMap(), 1, 0);
-    stochedge_y_A[1].define(stochedge_y[1].boxArray(), stochedge_y[1].DistributionMap(), 1, 0);
-
-    stochedge_z_A[0].define(stochedge_z[0].boxArray(), stochedge_z[0].DistributionMap(), 1, 0);
-    stochedge_z_A[1].define(stochedge_z[1].boxArray(), stochedge_z[1].DistributionMap(), 1, 0);
-
-    stochedge_x_A[0].setVal(0.0); stochedge_x_A[1].setVal(0.0);
-    stochedge_y_A[0].setVal(0.0); stochedge_y_A[1].setVal(0.0);
-    stochedge_z_A[0].setVal(0.0); stochedge_z_A[1].setVal(0.0);
-
-    std::array< MultiFab, AMREX_SPACEDIM > stochcen_A;
-    AMREX_D_TERM(stochcen_A[0].define(stochcen[0].boxArray(),stochcen[0].DistributionMap(),1,1);,
-                 stochcen_A[1].define(stochcen[1].boxArray(),stochcen[1].DistributionMap(),1,1);,
-                 stochcen_A[2].define(stochcen[2].boxArray(),stochcen[2].DistributionMap(),1,1););
-
-    AMREX_D_TERM(stochcen_A[0].setVal(0.0);,
-                 stochcen_A[1].setVal(0.0);,
-                 stochcen_A[2].setVal(0.0););
-
-    // field "B"
-    std::array< MultiFab, AMREX_SPACEDIM > stochface_B;
-    AMREX_D_TERM(stochface_B[0].define(stochface[0].boxArray(), stochface[0].DistributionMap(), nvars, 0);,
-                 stochface_B[1].define(stochface[1].boxArray(), stochface[1].DistributionMap(), nvars, 0);,
-                 stochface_B[2].define(stochface[2].boxArray(), stochface[2].DistributionMap(), nvars, 0););
-
-    AMREX_D_TERM(stochface_B[0].setVal(0.0);,
-                 stochface_B[1].setVal(0.0);,
-                 stochface_B[2].setVal(0.0););
-    
-    std::array< MultiFab, 2 > stochedge_x_B; 
-    std::array< MultiFab, 2 > stochedge_y_B; 
-    std::array< MultiFab, 2 > stochedge_z_B; 
-
-    stochedge_x_B[0].define(stochedge_x[0].boxArray(), stochedge_x[0].DistributionMap(), 1, 0); 
-    stochedge_x_B[1].define(stochedge_x[1].boxArray(), stochedge_x[1].DistributionMap(), 1, 0);
-             
-    stochedge_y_B[0].define(stochedge_y[0].boxArray(), stochedge_y[0].DistributionMap(), 1, 0);
-    stochedge_y_B[1].define(stochedge_y[1].boxArray(), stochedge_y[1].DistributionMap(), 1, 0);
-
-    stochedge_z_B[0].define(stochedge_z[0].boxArray(), stochedge_z[0].DistributionMap(), 1, 0);
-    stochedge_z_B[1].define(stochedge_z[1].boxArray(), stochedge_z[1].DistributionMap(), 1, 0);
-
-    stochedge_x_B[0].setVal(0.0); stochedge_x_B[1].setVal(0.0);
-    stochedge_y_B[0].setVal(0.0); stochedge_y_B[1].setVal(0.0);
-    stochedge_z_B[0].setVal(0.0); stochedge_z_B[1].setVal(0.0);
-
-    std::array< MultiFab, AMREX_SPACEDIM > stochcen_B;
-    AMREX_D_TERM(stochcen_B[0].define(stochcen[0].boxArray(),stochcen[0].DistributionMap(),1,1);,
-                 stochcen_B[1].define(stochcen[1].boxArray(),stochcen[1].DistributionMap(),1,1);,
-                 stochcen_B[2].define(stochcen[2].boxArray(),stochcen[2].DistributionMap(),1,1););
-
-    AMREX_D_TERM(stochcen_B[0].setVal(0.0);,
-                 stochcen_B[1].setVal(0.0);,
-                 stochcen_B[2].setVal(0.0););
-
     // fill random numbers (can skip density component 0)
     if (do_1D) { // 1D need only for x- face 
         for(int i=1;i<nvars;i++) {
@@ -262,7 +223,11 @@ void RK3stepStag(MultiFab& cu,
     }
     /////////////////////////////////////////////////////
 
-    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D);
+    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D, &prim_last);
+
+    if (transport_coeff_tol > 0. && transport_coeff_check_int > 0 && step%transport_coeff_check_int == 0) {
+        TransportCoeffsError(prim, eta, zeta, kappa, chi, D);
+    }
 
     calculateFluxStag(cu, cumom, prim, vel, eta, zeta, kappa, chi, D, 
         faceflux, edgeflux_x, edgeflux_y, edgeflux_z, cenflux, 
@@ -372,7 +337,7 @@ void RK3stepStag(MultiFab& cu,
     setBCStag(prim, cup, cupmom, vel, geom);
 
     // Compute transport coefs after setting BCs
-    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D);
+    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D, &prim_last);
 
     ///////////////////////////////////////////////////////////
     // Perform weighting of white noise fields
@@ -535,7 +500,7 @@ void RK3stepStag(MultiFab& cu,
     setBCStag(prim, cup2, cup2mom, vel, geom);
 
     // Compute transport coefs after setting BCs
-    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D);
+    calculateTransportCoeffs(prim, eta, zeta, kappa, chi, D, &prim_last);
 
     ///////////////////////////////////////////////////////////
     // Perform weighting of white noise fields
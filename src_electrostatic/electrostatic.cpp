@@ -2,20 +2,288 @@
 #include "common_functions.H"
 #include <AMReX_MLMG.H>
 
+#ifndef AMREX_USE_GPU
+#include <fftw3.h>
+#endif
+
+#include <cmath>
+#include <memory>
+
 using namespace amrex;
 
-void esSolve(MultiFab& potential, MultiFab& charge,
-             std::array< MultiFab, AMREX_SPACEDIM >& efieldCC,
-             const std::array< MultiFab, AMREX_SPACEDIM >& external, const Geometry geom)
+// Multigrid solver kept between calls of esSolve; the operator and its
+// coarsened hierarchy are only rebuilt when the grids change
+struct ESMultigrid {
+    Box domain;
+    BoxArray ba;
+    DistributionMapping dmap;
+    std::unique_ptr<MLPoisson> linop;
+    std::unique_ptr<MLMG> mlmg;
+};
+
+static ESMultigrid es_mg;
+
+#ifndef AMREX_USE_GPU
+// Spectral solver (poisson_fft = 1). Each direction must be periodic,
+// Dirichlet on both walls, or homogeneous Neumann on both walls. The charge is
+// gathered onto one rank, where the cell-centered second-order Laplacian is
+// diagonalized with real-to-real transforms: R2HC for periodic directions,
+// DST-II for Dirichlet and DCT-II for Neumann walls (the wall on the cell
+// face, as in MLPoisson).
+struct ESFFT {
+    Box domain;
+    BoxArray ba;
+    DistributionMapping dmap;
+
+    // charge, then potential, on a single box
+    MultiFab data;
+
+    // inverse eigenvalues of the Laplacian, including the transform
+    // normalization (zero for the null mode)
+    Vector<Real> inv_symbol;
+
+    bool plan_built = false;
+    fftw_plan forward;
+    fftw_plan backward;
+};
+
+static ESFFT es_fft;
+#endif
+
+// PPPM mode (es_tog = 3 with p3m_alpha > 0, periodic domains). The mesh
+// carries the long-range part erf(alpha r)/r of the Ewald split: the charge
+// is assigned with the B-spline of order p3m_order, the potential is found
+// with the optimal influence function of Hockney & Eastwood for that
+// assignment and the centred-difference gradient of ComputeCentredGrad, and
+// the field is interpolated back with the same B-spline. The erfc(alpha r)/r
+// part is summed over the neighbor list up to p3m_cutoff.
+struct ESP3M {
+    Box domain;
+
+    // per direction and mesh frequency: the aliased wave numbers k + 2 pi m/h,
+    // the squared transform of the B-spline U^2 = sinc(k h/2)^(2p) at each of
+    // them, its sum over (many more) images, and the transform sin(k h)/h of
+    // the centred difference; G_opt(k) is evaluated from these on the FFT
+    // rank only, straight into the solver's inverse symbol
+    Vector<Vector<Real>> km, u2, u2sum, dop;
+
+    // k-space sum Q of the Deserno & Holm force error estimate
+    Real err_sum = 0.;
+};
+
+static ESP3M es_p3m;
+
+// images per direction in the aliasing sums of the influence function
+static constexpr int p3m_alias = 2;
+
+static void ESClearSolvers()
 {
-    BL_PROFILE_VAR("esSolve()",esSolve);
+    es_mg.mlmg.reset();
+    es_mg.linop.reset();
+    es_mg.domain = Box();
 
-    AMREX_D_TERM(efieldCC[0].setVal(0);,
-                 efieldCC[1].setVal(0);,
-                 efieldCC[2].setVal(0););
+#ifndef AMREX_USE_GPU
+    if (es_fft.plan_built) {
+        fftw_destroy_plan(es_fft.forward);
+        fftw_destroy_plan(es_fft.backward);
+        es_fft.plan_built = false;
+    }
+    es_fft.data.clear();
+    Vector<Real>().swap(es_fft.inv_symbol);
+    es_fft.domain = Box();
+#endif
 
-    if(es_tog==1 || es_tog==3)
-    {
+    es_p3m = ESP3M();
+}
+
+static Real ESP3MSinc(Real x)
+{
+    return (x == 0.) ? 1. : std::sin(x)/x;
+}
+
+// G_opt at mesh frequency idx (in the layout of the FFT data); err is set to
+// its contribution to the Deserno & Holm sum
+static Real ESP3MInfluence(Long idx, Real& err)
+{
+    const IntVect len = es_p3m.domain.length();
+    const Real alpha2x4 = 4.*p3m_alpha*p3m_alpha;
+    const int na = 2*p3m_alias+1;
+
+    const auto& km = es_p3m.km;
+    const auto& u2 = es_p3m.u2;
+    const auto& u2sum = es_p3m.u2sum;
+    const auto& dop = es_p3m.dop;
+
+    int j[AMREX_SPACEDIM];
+    Long r = idx;
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        j[d] = r % len[d];
+        r /= len[d];
+    }
+
+    Real d2 = 0.;
+    Real den = 1.;
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        d2 += dop[d][j[d]]*dop[d][j[d]];
+        den *= u2sum[d][j[d]];
+    }
+
+    // sum over the aliases k_m of U^2(k_m) D(k).k_m R(k_m) and |R(k_m)|^2,
+    // with the reference potential R(k) = exp(-k^2/(4 alpha^2))/k^2
+    Real num = 0.;
+    Real ref = 0.;
+    int a[3] = {0, 0, 0};
+    const int na_z = (AMREX_SPACEDIM == 3) ? na : 1;
+    for (a[2]=0; a[2]<na_z; ++a[2]) {
+    for (a[1]=0; a[1]<na; ++a[1]) {
+    for (a[0]=0; a[0]<na; ++a[0]) {
+        Real k2 = 0.;
+        Real dk = 0.;
+        Real u = 1.;
+        for (int d=0; d<AMREX_SPACEDIM; ++d) {
+            const Real kk = km[d][j[d]*na+a[d]];
+            k2 += kk*kk;
+            dk += dop[d][j[d]]*kk;
+            u *= u2[d][j[d]*na+a[d]];
+        }
+        if (k2 == 0.) {
+            continue;
+        }
+        const Real g = std::exp(-k2/alpha2x4)/k2;
+        num += u*dk*g;
+        ref += k2*g*g;
+    }
+    }
+    }
+
+    // the field vanishes where the centred difference does (null mode)
+    if (d2 == 0.) {
+        err = ref;
+        return 0.;
+    }
+    err = ref - num*num/(d2*den*den);
+    return num/(d2*den*den);
+}
+
+// Build the per-direction tables of the influence function and the k-space
+// error sum; must be called on all ranks
+static void ESP3MSetup(const Geometry& geom)
+{
+    BL_PROFILE_VAR("ESP3MSetup()",ESP3MSetup);
+
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        if (bc_es_lo[d] != -1 || bc_es_hi[d] != -1) {
+            Abort("esSolve: the PPPM mode (p3m_alpha > 0) needs a periodic electrostatic domain");
+        }
+    }
+    if (p3m_order < 1 || p3m_order > 7) {
+        Abort("esSolve: p3m_order must be between 1 and 7");
+    }
+    if (p3m_cutoff <= 0.) {
+        Abort("esSolve: the PPPM mode (p3m_alpha > 0) needs p3m_cutoff > 0");
+    }
+
+    const Box& domain = geom.Domain();
+    const Real* dx = geom.CellSize();
+    const IntVect len = domain.length();
+    const int na = 2*p3m_alias+1;
+
+    es_p3m.domain = domain;
+    es_p3m.km.resize(AMREX_SPACEDIM);
+    es_p3m.u2.resize(AMREX_SPACEDIM);
+    es_p3m.u2sum.resize(AMREX_SPACEDIM);
+    es_p3m.dop.resize(AMREX_SPACEDIM);
+
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        const int nd = len[d];
+        es_p3m.km[d].resize(nd*na);
+        es_p3m.u2[d].resize(nd*na);
+        es_p3m.u2sum[d].resize(nd);
+        es_p3m.dop[d].resize(nd);
+
+        for (int j=0; j<nd; ++j) {
+            const int f = (j <= nd/2) ? j : j-nd;
+            const Real k = 2.*M_PI*f/(nd*dx[d]);
+
+            es_p3m.dop[d][j] = std::sin(k*dx[d])/dx[d];
+
+            for (int a=0; a<na; ++a) {
+                const Real kk = k + 2.*M_PI*(a-p3m_alias)/dx[d];
+                es_p3m.km[d][j*na+a] = kk;
+                es_p3m.u2[d][j*na+a] = std::pow(ESP3MSinc(0.5*kk*dx[d]), 2*p3m_order);
+            }
+
+            Real sum = 0.;
+            for (int m=-50; m<=50; ++m) {
+                sum += std::pow(ESP3MSinc(0.5*(k + 2.*M_PI*m/dx[d])*dx[d]), 2*p3m_order);
+            }
+            es_p3m.u2sum[d][j] = sum;
+        }
+    }
+
+    // the error sum runs over all mesh frequencies, so split it over the ranks
+    const Long npts = domain.numPts();
+    const Long nprocs = ParallelDescriptor::NProcs();
+    const Long myproc = ParallelDescriptor::MyProc();
+    const Long ibeg = npts*myproc/nprocs;
+    const Long iend = npts*(myproc+1)/nprocs;
+
+    Real err = 0.;
+
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:err)
+#endif
+    for (Long idx=ibeg; idx<iend; ++idx) {
+        Real err_idx;
+        ESP3MInfluence(idx, err_idx);
+        err += err_idx;
+    }
+
+    ParallelDescriptor::ReduceRealSum(err);
+
+    // the force transform of R is -i k 4 pi R(k) (unit Coulomb constant)
+    es_p3m.err_sum = 16.*M_PI*M_PI*err/AMREX_D_TERM(geom.ProbLength(0),*geom.ProbLength(1),*geom.ProbLength(2));
+}
+
+void esP3MErrorEstimate(const Geometry& geom, Real sum_q2, Real npart)
+{
+    if (es_p3m.domain != geom.Domain()) {
+        ESP3MSetup(geom);
+    }
+
+    const Real vol = AMREX_D_TERM(geom.ProbLength(0),*geom.ProbLength(1),*geom.ProbLength(2));
+    const Real ee = 1.0/(permittivity*4*M_PI);
+    const Real alpha = p3m_alpha;
+    const Real rc = p3m_cutoff;
+
+    // rms force errors: Kolafa & Perram for the truncated real-space sum,
+    // Deserno & Holm for the mesh part
+    const Real err_real = 2.*ee*sum_q2*std::exp(-alpha*alpha*rc*rc)/std::sqrt(npart*rc*vol);
+    const Real err_kspace = ee*sum_q2*std::sqrt(es_p3m.err_sum/(npart*vol));
+
+    Print() << "PPPM: alpha " << alpha << ", cutoff " << rc << ", order " << p3m_order
+            << ", mesh " << geom.Domain().length() << "\n"
+            << "PPPM: rms force error estimate " << std::sqrt(err_real*err_real + err_kspace*err_kspace)
+            << " (real space " << err_real << ", k-space " << err_kspace << ")\n";
+}
+
+static void ESRegisterCleanup()
+{
+    static bool registered = false;
+    if (!registered) {
+        amrex::ExecOnFinalize(ESClearSolvers);
+        registered = true;
+    }
+}
+
+static void ESMultigridSolve(MultiFab& potential, MultiFab& charge, const Geometry& geom)
+{
+    const BoxArray& ba = charge.boxArray();
+    const DistributionMapping& dmap = charge.DistributionMap();
+
+    if (!es_mg.mlmg || es_mg.domain != geom.Domain() || es_mg.ba != ba || es_mg.dmap != dmap) {
+
+        ESRegisterCleanup();
 
         LinOpBCType lo_linop_bc[3];
         LinOpBCType hi_linop_bc[3];
@@ -36,7 +304,7 @@ void esSolve(MultiFab& potential, MultiFab& charge,
 //                hi_linop_bc[i] = LinOpBCType::Neumann;
             }
             if(bc_es_lo[i] == 1)
-            {                 
+            {
                 lo_linop_bc[i] = LinOpBCType::Dirichlet;
             }
             if(bc_es_hi[i] == 1)
@@ -45,51 +313,287 @@ void esSolve(MultiFab& potential, MultiFab& charge,
             }
         }
 
-        const BoxArray& ba = charge.boxArray();
-        const DistributionMapping& dmap = charge.DistributionMap();
+        // the solver refers to the operator, so it goes first
+        es_mg.mlmg.reset();
 
         //create solver opject
-        MLPoisson linop({geom}, {ba}, {dmap});
- 
-        //set BCs
-        linop.setDomainBC({AMREX_D_DECL(lo_linop_bc[0],
-                                        lo_linop_bc[1],
-                                        lo_linop_bc[2])},
-                          {AMREX_D_DECL(hi_linop_bc[0],
-                                        hi_linop_bc[1],
-                                        hi_linop_bc[2])});
+        es_mg.linop.reset(new MLPoisson({geom}, {ba}, {dmap}));
 
-        // fill in ghost cells with Dirichlet/Neumann values
-        // the ghost cells will hold the value ON the boundary
-        MultiFabPotentialBC_solver(potential,geom);
-
-        // tell MLPoisson about these potentially inhomogeneous BC values
-        linop.setLevelBC(0, &potential);
+        //set BCs
+        es_mg.linop->setDomainBC({AMREX_D_DECL(lo_linop_bc[0],
+                                               lo_linop_bc[1],
+                                               lo_linop_bc[2])},
+                                 {AMREX_D_DECL(hi_linop_bc[0],
+                                               hi_linop_bc[1],
+                                               hi_linop_bc[2])});
 
         // this forces the solver to NOT enforce solvability
         // thus if there are Neumann conditions on phi they must
         // be correct or the Poisson solver won't converge
-        linop.setEnforceSingularSolvable(false);
+        es_mg.linop->setEnforceSingularSolvable(false);
 
         //Multi Level Multi Grid
-        MLMG mlmg(linop);
+        es_mg.mlmg.reset(new MLMG(*es_mg.linop));
 
         //Solver parameters
-        mlmg.setMaxIter(poisson_max_iter);
-        mlmg.setVerbose(poisson_verbose);
-        mlmg.setBottomVerbose(poisson_bottom_verbose);
-        
-        //Do solve
-        mlmg.solve({&potential}, {&charge}, poisson_rel_tol, 0.0);
-            
+        es_mg.mlmg->setMaxIter(poisson_max_iter);
+        es_mg.mlmg->setVerbose(poisson_verbose);
+        es_mg.mlmg->setBottomVerbose(poisson_bottom_verbose);
+
+        es_mg.domain = geom.Domain();
+        es_mg.ba = ba;
+        es_mg.dmap = dmap;
+    }
+
+    // fill in ghost cells with Dirichlet/Neumann values
+    // the ghost cells will hold the value ON the boundary
+    MultiFabPotentialBC_solver(potential,geom);
+
+    // tell MLPoisson about these potentially inhomogeneous BC values
+    es_mg.linop->setLevelBC(0, &potential);
+
+    //Do solve; the previous potential is the initial guess
+    es_mg.mlmg->solve({&potential}, {&charge}, poisson_rel_tol, 0.0);
+}
+
+#ifndef AMREX_USE_GPU
+// true if the boundary conditions are ones the spectral solver handles:
+// every direction periodic, Dirichlet on both walls, or homogeneous Neumann on
+// both walls; nonzero wall potentials only if there is a single wall-bounded
+// direction (they are then added as a linear profile)
+static bool ESFFTSupported()
+{
+    int nwalled = 0;
+    bool inhomog_dirichlet = false;
+
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        if (bc_es_lo[d] == -1 && bc_es_hi[d] == -1) {
+            continue;
+        }
+        ++nwalled;
+        if (bc_es_lo[d] == 1 && bc_es_hi[d] == 1) {
+            if (potential_lo[d] != 0. || potential_hi[d] != 0.) {
+                inhomog_dirichlet = true;
+            }
+        } else if (bc_es_lo[d] == 2 && bc_es_hi[d] == 2) {
+            if (potential_lo[d] != 0. || potential_hi[d] != 0.) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return !(inhomog_dirichlet && nwalled > 1);
+}
+
+static void ESFFTSetup(const Geometry& geom)
+{
+    BL_PROFILE_VAR("ESFFTSetup()",ESFFTSetup);
+
+    ESRegisterCleanup();
+
+    if (es_fft.plan_built) {
+        fftw_destroy_plan(es_fft.forward);
+        fftw_destroy_plan(es_fft.backward);
+        es_fft.plan_built = false;
+    }
+
+    const Box& domain = geom.Domain();
+    const Real* dx = geom.CellSize();
+
+    // the whole domain on the rank chosen by the default DistributionMapping
+    es_fft.domain = domain;
+    es_fft.ba = BoxArray(domain);
+    es_fft.dmap = DistributionMapping(es_fft.ba);
+    es_fft.data.define(es_fft.ba, es_fft.dmap, 1, 0);
+
+    const bool pppm = (es_tog == 3 && p3m_alpha > 0.);
+    if (pppm && es_p3m.domain != domain) {
+        ESP3MSetup(geom);
+    }
+
+    if (es_fft.dmap[0] != ParallelDescriptor::MyProc()) {
+        return;
+    }
+
+    // FFTW is row-major, so the x direction is the last (fastest) one
+    int n[AMREX_SPACEDIM];
+    fftw_r2r_kind kind_fwd[AMREX_SPACEDIM];
+    fftw_r2r_kind kind_bwd[AMREX_SPACEDIM];
+    Real norm = 1.;
+
+    // eigenvalues of the 1D second difference in each direction
+    Vector<Vector<Real>> lambda(AMREX_SPACEDIM);
+
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        const int nd = domain.length(d);
+        const int f = AMREX_SPACEDIM-1-d;
+        n[f] = nd;
+        lambda[d].resize(nd);
+
+        const Real fac = 4./(dx[d]*dx[d]);
+
+        if (bc_es_lo[d] == -1) {
+            kind_fwd[f] = FFTW_R2HC;
+            kind_bwd[f] = FFTW_HC2R;
+            norm *= nd;
+            // halfcomplex index k holds frequency k or nd-k; both give the same value
+            for (int k=0; k<nd; ++k) {
+                Real s = std::sin(M_PI*k/nd);
+                lambda[d][k] = -fac*s*s;
+            }
+        } else if (bc_es_lo[d] == 1) {
+            kind_fwd[f] = FFTW_RODFT10;
+            kind_bwd[f] = FFTW_RODFT01;
+            norm *= 2*nd;
+            for (int k=0; k<nd; ++k) {
+                Real s = std::sin(0.5*M_PI*(k+1)/nd);
+                lambda[d][k] = -fac*s*s;
+            }
+        } else {
+            kind_fwd[f] = FFTW_REDFT10;
+            kind_bwd[f] = FFTW_REDFT01;
+            norm *= 2*nd;
+            for (int k=0; k<nd; ++k) {
+                Real s = std::sin(0.5*M_PI*k/nd);
+                lambda[d][k] = -fac*s*s;
+            }
+        }
+    }
+
+    const Long npts = domain.numPts();
+    es_fft.inv_symbol.resize(npts);
+
+    const IntVect len = domain.length();
+    for (Long idx=0; idx<npts; ++idx) {
+        Long r = idx;
+        Real lam = 0.;
+        for (int d=0; d<AMREX_SPACEDIM; ++d) {
+            lam += lambda[d][r % len[d]];
+            r /= len[d];
+        }
+        // the null mode (periodic/Neumann) is set to zero: zero-mean potential
+        es_fft.inv_symbol[idx] = (lam != 0.) ? 1./(lam*norm) : 0.;
+    }
+
+    // PPPM: the charge is -rho/eps and the long-range potential is
+    // rho/eps G_opt, so the Laplacian inverse is replaced by -G_opt
+    if (pppm) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (Long idx=0; idx<npts; ++idx) {
+            Real err_idx;
+            es_fft.inv_symbol[idx] = -ESP3MInfluence(idx, err_idx)/norm;
+        }
+    }
+
+    // in-place transforms of the single fab
+    Real* ptr = es_fft.data[0].dataPtr();
+    es_fft.forward  = fftw_plan_r2r(AMREX_SPACEDIM, n, ptr, ptr, kind_fwd, FFTW_MEASURE);
+    es_fft.backward = fftw_plan_r2r(AMREX_SPACEDIM, n, ptr, ptr, kind_bwd, FFTW_MEASURE);
+    es_fft.plan_built = true;
+}
+
+static void ESFFTSolve(MultiFab& potential, const MultiFab& charge, const Geometry& geom)
+{
+    BL_PROFILE_VAR("ESFFTSolve()",ESFFTSolve);
+
+    if (es_fft.domain != geom.Domain()) {
+        ESFFTSetup(geom);
+    }
+
+    es_fft.data.ParallelCopy(charge, 0, 0, 1);
+
+    if (es_fft.plan_built) {
+        Real* ptr = es_fft.data[0].dataPtr();
+        const Real* inv_symbol = es_fft.inv_symbol.dataPtr();
+        const Long npts = es_fft.domain.numPts();
+
+        fftw_execute(es_fft.forward);
+        for (Long idx=0; idx<npts; ++idx) {
+            ptr[idx] *= inv_symbol[idx];
+        }
+        fftw_execute(es_fft.backward);
+    }
+
+    potential.ParallelCopy(es_fft.data, 0, 0, 1);
+
+    // nonzero wall potentials: add the linear profile between them, which is
+    // harmonic and matches the walls
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        if (bc_es_lo[d] == 1 && (potential_lo[d] != 0. || potential_hi[d] != 0.)) {
+
+            const Real lo = geom.ProbLo(d);
+            const Real len = geom.ProbHi(d) - lo;
+            const Real dxd = geom.CellSize(d);
+            const Real pot_lo = potential_lo[d];
+            const Real pot_hi = potential_hi[d];
+
+            for (MFIter mfi(potential); mfi.isValid(); ++mfi) {
+                const Box& bx = mfi.validbox();
+                const Array4<Real>& pot = potential.array(mfi);
+
+                amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    const IntVect iv(AMREX_D_DECL(i,j,k));
+                    const Real x = lo + (iv[d] + 0.5)*dxd;
+                    pot(i,j,k) += pot_lo + (pot_hi - pot_lo)*(x - lo)/len;
+                });
+            }
+        }
+    }
+}
+#endif
+
+void esSolve(MultiFab& potential, MultiFab& charge,
+             std::array< MultiFab, AMREX_SPACEDIM >& efieldCC,
+             const std::array< MultiFab, AMREX_SPACEDIM >& external, const Geometry geom)
+{
+    BL_PROFILE_VAR("esSolve()",esSolve);
+
+    AMREX_D_TERM(efieldCC[0].setVal(0);,
+                 efieldCC[1].setVal(0);,
+                 efieldCC[2].setVal(0););
+
+    if(es_tog==1 || es_tog==3)
+    {
+        bool use_fft = false;
+
+        if (es_tog == 3 && p3m_alpha > 0.) {
+#ifdef AMREX_USE_GPU
+            Abort("esSolve: the PPPM mode (p3m_alpha > 0) needs the FFT solver, which is not available on GPU");
+#endif
+            use_fft = true;
+        } else if (poisson_fft == 1) {
+#ifndef AMREX_USE_GPU
+            use_fft = ESFFTSupported();
+#endif
+            static bool warned = false;
+            if (!use_fft && !warned) {
+                Print() << "esSolve: FFT Poisson solver not available for these boundary conditions"
+                        << " or on GPU; using multigrid\n";
+                warned = true;
+            }
+        }
+
+        if (use_fft) {
+#ifndef AMREX_USE_GPU
+            ESFFTSolve(potential, charge, geom);
+#endif
+        } else {
+            ESMultigridSolve(potential, charge, geom);
+        }
+
         potential.FillBoundary(geom.periodicity());
         // set ghost cell values so electric field is calculated properly
         // the ghost cells will hold the values extrapolated to the ghost CC
-        MultiFabPotentialBC(potential, geom); 
+        MultiFabPotentialBC(potential, geom);
 
         //Find e field, gradient from cell centers to faces
         ComputeCentredGrad(potential, efieldCC, geom);
-        
+
 
     }
 
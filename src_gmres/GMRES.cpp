@@ -5,6 +5,9 @@ GMRES::GMRES (const BoxArray& ba_in,
               const Geometry& geom_in) {
 
     BL_PROFILE_VAR("GMRES::GMRES()", GMRES);
+
+    ba = ba_in;
+    dmap = dmap_in;
     
     for (int d=0; d<AMREX_SPACEDIM; ++d) {
         r_u[d]        .define(convert(ba_in, nodal_flag_dir[d]), dmap_in, 1,                 1);
@@ -25,6 +28,12 @@ GMRES::GMRES (const BoxArray& ba_in,
     Pcon.Define(ba_in,dmap_in,geom_in);
 }
 
+bool GMRES::SameGrids (const BoxArray& ba_in,
+                       const DistributionMapping& dmap_in) const
+{
+    return (ba == ba_in && dmap == dmap_in);
+}
+
 
 void GMRES::Solve (std::array<MultiFab, AMREX_SPACEDIM> & b_u, MultiFab & b_p,
                    std::array<MultiFab, AMREX_SPACEDIM> & x_u, MultiFab & x_p,
@@ -38,6 +47,10 @@ void GMRES::Solve (std::array<MultiFab, AMREX_SPACEDIM> & b_u, MultiFab & b_p,
 
     BL_PROFILE_VAR("GMRES::Solve()", GMRES_Solve);
 
+    if (!SameGrids(b_p.boxArray(), b_p.DistributionMap())) {
+        Abort("GMRES::Solve: grids have changed since the solver was built; rebuild GMRES after regridding");
+    }
+
     if (gmres_verbose >= 1) {
         Print() << "Begin call to GMRES" << std::endl;
     }
@@ -68,6 +81,9 @@ void GMRES::Solve (std::array<MultiFab, AMREX_SPACEDIM> & b_u, MultiFab & b_p,
     Vector<Real> inner_prod_vel(AMREX_SPACEDIM);
     Real inner_prod_pres;
 
+    // fused inner products against the Krylov basis (gmres_orthog = 1)
+    Vector<Real> prod(gmres_max_inner+1);
+
     //////////////////////////////////////
     // account for inhomogeneous boundary conditions, e.g., moving walls
     // use r_u, tmp_u, r_p, tmp_p as temporary storage
@@ -143,6 +159,10 @@ void GMRES::Solve (std::array<MultiFab, AMREX_SPACEDIM> & b_u, MultiFab & b_p,
     }
 
 
+    // the coefficients are fixed for the rest of the solve, so set up the
+    // preconditioner once rather than on every application
+    Pcon.Setup(alpha_fc, alphainv_fc, beta, beta_ed, gamma, theta_alpha, StagSolver);
+
     // First application of preconditioner
     Pcon.Apply(b_u, b_p, tmp_u, tmp_p, alpha_fc, alphainv_fc,
                beta, beta_ed, gamma, theta_alpha, geom, StagSolver);
@@ -377,32 +397,83 @@ void GMRES::Solve (std::array<MultiFab, AMREX_SPACEDIM> & b_u, MultiFab & b_p,
 
             //___________________________________________________________________
             // Form Hessenberg matrix H
-            for (int k=0; k<=i; ++k) {
-                // H(k,i) = dot_product(w, V(k))
-                //        = dot_product(w_u, V_u(k))+dot_product(w_p, V_p(k))
-                StagInnerProd(w_u, 0, V_u, k, scr_u, inner_prod_vel);
-                CCInnerProd(w_p, 0, V_p, k, scr_p, inner_prod_pres);
-                H[k][i] = std::accumulate(inner_prod_vel.begin(), inner_prod_vel.end(), 0.) 
-                          + pow(p_norm_weight, 2.0)*inner_prod_pres;
+            if (gmres_orthog == 0) {
+
+                // modified Gram-Schmidt
+                for (int k=0; k<=i; ++k) {
+                    // H(k,i) = dot_product(w, V(k))
+                    //        = dot_product(w_u, V_u(k))+dot_product(w_p, V_p(k))
+                    StagInnerProd(w_u, 0, V_u, k, scr_u, inner_prod_vel);
+                    CCInnerProd(w_p, 0, V_p, k, scr_p, inner_prod_pres);
+                    H[k][i] = std::accumulate(inner_prod_vel.begin(), inner_prod_vel.end(), 0.) 
+                              + pow(p_norm_weight, 2.0)*inner_prod_pres;
+
+
+                    // w = w - H(k,i) * V(k)
+                    // use tmp_u and tmp_p as temporaries to hold kth component of V(k)
+                    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+                        MultiFab::Copy(tmp_u[d], V_u[d], k, 0, 1, 0);
+                        tmp_u[d].mult(H[k][i], 0, 1, 0);
+                        MultiFab::Subtract(w_u[d], tmp_u[d], 0, 0, 1, 0);
+                    }
+                    MultiFab::Copy(tmp_p, V_p, k, 0, 1, 0);
+                    tmp_p.mult(H[k][i], 0, 1, 0);
+                    MultiFab::Subtract(w_p,tmp_p, 0, 0, 1, 0);
+                }
 
+                // H(i+1,i) = norm(w)
+                StagL2Norm(w_u, 0, scr_u, norm_u);
+                CCL2Norm(w_p, 0, scr_p, norm_p);
+                norm_p    = p_norm_weight*norm_p;
+                H[i+1][i] = sqrt(norm_u*norm_u + norm_p*norm_p);
+            }
+            else if (gmres_orthog == 1) {
 
-                // w = w - H(k,i) * V(k)
-                // use tmp_u and tmp_p as temporaries to hold kth component of V(k)
-                for (int d=0; d<AMREX_SPACEDIM; ++d) {
-                    MultiFab::Copy(tmp_u[d], V_u[d], k, 0, 1, 0);
-                    tmp_u[d].mult(H[k][i], 0, 1, 0);
-                    MultiFab::Subtract(w_u[d], tmp_u[d], 0, 0, 1, 0);
+                // classical Gram-Schmidt with one reorthogonalization pass (CGS2)
+                // each pass needs a single global reduction for all i+1 inner
+                // products plus <w,w>, instead of one reduction per basis vector
+                for (int k=0; k<=i; ++k) {
+                    H[k][i] = 0.;
                 }
-                MultiFab::Copy(tmp_p, V_p, k, 0, 1, 0);
-                tmp_p.mult(H[k][i], 0, 1, 0);
-                MultiFab::Subtract(w_p,tmp_p, 0, 0, 1, 0);
-            }
 
-            // H(i+1,i) = norm(w)
-            StagL2Norm(w_u, 0, scr_u, norm_u);
-            CCL2Norm(w_p, 0, scr_p, norm_p);
-            norm_p    = p_norm_weight*norm_p;
-            H[i+1][i] = sqrt(norm_u*norm_u + norm_p*norm_p);
+                Real norm_w2 = 0.;
+
+                for (int pass=0; pass<2; ++pass) {
+
+                    // prod(k) = dot_product(w, V(k)), prod(i+1) = dot_product(w,w)
+                    KrylovInnerProd(w_u, w_p, i+1, prod);
+
+                    // w = w - sum_k prod(k) * V(k)
+                    for (int k=0; k<=i; ++k) {
+                        H[k][i] += prod[k];
+                        for (int d=0; d<AMREX_SPACEDIM; ++d) {
+                            MultiFab::Saxpy(w_u[d], -prod[k], V_u[d], k, 0, 1, 0);
+                        }
+                        MultiFab::Saxpy(w_p, -prod[k], V_p, k, 0, 1, 0);
+                    }
+
+                    // since V is orthonormal, |w - V prod|^2 = |w|^2 - |prod|^2
+                    norm_w2 = prod[i+1];
+                    for (int k=0; k<=i; ++k) {
+                        norm_w2 -= prod[k]*prod[k];
+                    }
+                }
+
+                // after reorthogonalization the correction is tiny, so the norm from
+                // the second pass is accurate unless it is dominated by roundoff
+                if (norm_w2 > 0.) {
+                    H[i+1][i] = sqrt(norm_w2);
+                }
+                else {
+                    StagL2Norm(w_u, 0, scr_u, norm_u);
+                    CCL2Norm(w_p, 0, scr_p, norm_p);
+                    norm_p    = p_norm_weight*norm_p;
+                    H[i+1][i] = sqrt(norm_u*norm_u + norm_p*norm_p);
+                }
+            }
+            else {
+                Abort("GMRES.cpp: invalid gmres_orthog");
+            }
 
 
             //___________________________________________________________________
@@ -493,6 +564,72 @@ void GMRES::Solve (std::array<MultiFab, AMREX_SPACEDIM> & b_u, MultiFab & b_p,
 
 }
 
+void GMRES::KrylovInnerProd (const std::array<MultiFab, AMREX_SPACEDIM> & x_u,
+                             const MultiFab & x_p,
+                             int nvec,
+                             Vector<Real> & prod)
+{
+    BL_PROFILE_VAR("GMRES::KrylovInnerProd()", GMRES_KrylovInnerProd);
+
+    const Real p_weight = p_norm_weight*p_norm_weight;
+
+    for (int n=0; n<=nvec; ++n) {
+
+        // n == nvec is <x,x>
+        const MultiFab& Vp = (n < nvec) ? V_p : x_p;
+        const int vcomp    = (n < nvec) ? n   : 0;
+
+        ReduceOps<ReduceOpSum> reduce_op;
+        ReduceData<Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+
+        // faces on grid boundaries are shared by two grids and carry weight 1/2,
+        // consistent with SumStag
+        for (int d=0; d<AMREX_SPACEDIM; ++d) {
+
+            const MultiFab& Vu = (n < nvec) ? V_u[d] : x_u[d];
+
+            for (MFIter mfi(x_u[d],TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+                const Box& bx = mfi.tilebox();
+                const Box& bx_grid = mfi.validbox();
+
+                const Array4<Real const> & x = x_u[d].array(mfi);
+                const Array4<Real const> & v = Vu.array(mfi);
+
+                const int lo = bx_grid.smallEnd(d);
+                const int hi = bx_grid.bigEnd(d);
+
+                reduce_op.eval(bx, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    IntVect iv(AMREX_D_DECL(i,j,k));
+                    Real weight = (iv[d]>lo && iv[d]<hi) ? 1.0 : 0.5;
+                    return {x(i,j,k)*v(i,j,k,vcomp)*weight};
+                });
+            }
+        }
+
+        for (MFIter mfi(x_p,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+            const Box& bx = mfi.tilebox();
+
+            const Array4<Real const> & x = x_p.array(mfi);
+            const Array4<Real const> & v = Vp.array(mfi);
+
+            reduce_op.eval(bx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                return {p_weight*x(i,j,k)*v(i,j,k,vcomp)};
+            });
+        }
+
+        prod[n] = amrex::get<0>(reduce_data.value());
+    }
+
+    ParallelDescriptor::ReduceRealSum(prod.dataPtr(), nvec+1);
+}
+
 void UpdateSol(std::array<MultiFab, AMREX_SPACEDIM>& x_u,
                MultiFab& x_p,
                std::array<MultiFab, AMREX_SPACEDIM>& V_u,
@@ -32,44 +32,73 @@ void MacProj::Define(const BoxArray& ba,
 }
     
 
-void MacProj::Solve(const std::array<MultiFab, AMREX_SPACEDIM>& alphainv_fc,
-                    MultiFab& mac_rhs,
-                    MultiFab& phi,
-                    const Geometry& geom,
-                    bool full_solve)
+void MacProj::Setup(const std::array<MultiFab, AMREX_SPACEDIM>& alphainv_fc,
+                    bool full_solve_in)
 {
-    BL_PROFILE_VAR("MacProj()",MacProj);
+    BL_PROFILE_VAR("MacProj::Setup()",MacProj_Setup);
+
+    full_solve = full_solve_in;
 
     int lev=0;
-    mlabec.setLevelBC(lev, &phi);
+
+    // boundary conditions are periodic or homogeneous Neumann
+    mlabec.setLevelBC(lev, nullptr);
 
     // coefficients for solver (alpha already set to zero via setScalars)
+    // these are averaged down to the coarser levels on the first solve only
     mlabec.setBCoeffs(lev,amrex::GetArrOfConstPtrs(alphainv_fc));
 
-    MLMG mlmg(mlabec);
+    mlmg.reset(new MLMG(mlabec));
 
-    mlmg.setVerbose(mg_verbose);
-    mlmg.setBottomVerbose(cg_verbose);
+    mlmg->setVerbose(mg_verbose);
+    mlmg->setBottomVerbose(cg_verbose);
 
     // for the preconditioner, we do 1 v-cycle and the bottom solver is smooths
     if (!full_solve) {
-        if (mg_bottom_solver == 0) {
-            mlmg.setBottomSolver(amrex::MLMG::BottomSolver::smoother);
-        }
-        else if (mg_bottom_solver == 1) {
-            mlmg.setBottomSolver(amrex::MLMG::BottomSolver::bicgstab);
+        if (mg_precon_vcycles > 0) {
+            // low-accuracy mode: a fixed number of V-cycles, smoothing at the bottom
+            mlmg->setBottomSolver(amrex::MLMG::BottomSolver::smoother);
+            mlmg->setFixedIter(mg_precon_vcycles);
         }
         else {
-            Abort("MacProj.cpp: only mg_bottom_solver=0");
+            if (mg_bottom_solver == 0) {
+                mlmg->setBottomSolver(amrex::MLMG::BottomSolver::smoother);
+            }
+            else if (mg_bottom_solver == 1) {
+                mlmg->setBottomSolver(amrex::MLMG::BottomSolver::bicgstab);
+            }
+            else {
+                Abort("MacProj.cpp: only mg_bottom_solver=0");
+            }
+            mlmg->setFixedIter(mg_max_vcycles);
         }
-        mlmg.setFixedIter(mg_max_vcycles);
-        mlmg.setPreSmooth(mg_nsmooths_down);
-        mlmg.setPostSmooth(mg_nsmooths_up);
-        mlmg.setFinalSmooth(mg_nsmooths_bottom);
+        mlmg->setPreSmooth(mg_nsmooths_down);
+        mlmg->setPostSmooth(mg_nsmooths_up);
+        mlmg->setFinalSmooth(mg_nsmooths_bottom);
     }
+}
 
-    mlmg.solve({&phi}, {&mac_rhs}, mg_rel_tol, mg_abs_tol);
+void MacProj::Solve(MultiFab& mac_rhs,
+                    MultiFab& phi,
+                    const Geometry& geom)
+{
+    BL_PROFILE_VAR("MacProj()",MacProj);
+
+    if (!mlmg) {
+        Abort("MacProj::Solve: Setup must be called first");
+    }
+
+    mlmg->solve({&phi}, {&mac_rhs}, mg_rel_tol, mg_abs_tol);
 
     phi.FillBoundary(geom.periodicity());
 }
 
+void MacProj::Solve(const std::array<MultiFab, AMREX_SPACEDIM>& alphainv_fc,
+                    MultiFab& mac_rhs,
+                    MultiFab& phi,
+                    const Geometry& geom,
+                    bool full_solve_in)
+{
+    Setup(alphainv_fc,full_solve_in);
+    Solve(mac_rhs,phi,geom);
+}
@@ -20,6 +20,21 @@ void Precon::Define(const BoxArray& ba_in,
 
 }    
 
+void Precon::Setup(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
+                   const std::array<MultiFab, AMREX_SPACEDIM> & alphainv_fc,
+                   const MultiFab & beta, const std::array<MultiFab, NUM_EDGE> & beta_ed,
+                   const MultiFab & gamma,
+                   const Real & theta_alpha,
+                   StagMGSolver& StagSolver)
+{
+    BL_PROFILE_VAR("Precon::Setup()",Precon_Setup);
+
+    if (amrex::Math::abs(precon_type) == 1) {
+        StagSolver.SetCoefficients(alpha_fc,beta,beta_ed,gamma,theta_alpha);
+        macproj.Setup(alphainv_fc);
+    }
+}
+
 void Precon::Apply(const std::array<MultiFab, AMREX_SPACEDIM> & b_u,
                    const MultiFab & b_p,
                    std::array<MultiFab, AMREX_SPACEDIM> & x_u,
@@ -64,7 +79,8 @@ void Precon::Apply(const std::array<MultiFab, AMREX_SPACEDIM> & b_u,
         ////////////////////
 
         // x_u^star = A^{-1} b_u
-        StagSolver.Solve(alpha_fc,beta,beta_ed,gamma,x_u,b_u,theta_alpha);
+        // the coefficients were pushed to all levels in Setup
+        StagSolver.Solve(alpha_fc,beta,beta_ed,gamma,x_u,b_u,theta_alpha,true);
 
         ////////////////////
         // STEP 2: Construct RHS for pressure Poisson problem
@@ -82,7 +98,7 @@ void Precon::Apply(const std::array<MultiFab, AMREX_SPACEDIM> & b_u,
 
         // use multigrid to solve for Phi
         // x_u^star is only passed in to get a norm for absolute residual criteria
-        macproj.Solve(alphainv_fc,mac_rhs,phi,geom);
+        macproj.Solve(mac_rhs,phi,geom);
 
         // x_u = x_u^star - (alpha I)^-1 grad Phi
         SubtractWeightedGradP(x_u,alphainv_fc,phi,gradp,geom);
@@ -53,8 +53,6 @@ void stag_applyop_visc_p1 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
-
     Real dxsqinv = 1./(dx[0]*dx[0]);
     Real dysqinv = 1./(dx[1]*dx[1]);
 #if (AMREX_SPACEDIM == 3)
@@ -78,12 +76,8 @@ void stag_applyop_visc_p1 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
 
             Lphix(i,j,k) = phix(i,j,k)*(theta_alpha*alphax(i,j,k) + term1)
                 -(phix(i+1,j,k)+phix(i-1,j,k))*term2
@@ -101,12 +95,8 @@ void stag_applyop_visc_p1 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
 
             Lphiy(i,j,k) = phiy(i,j,k)*(theta_alpha*alphay(i,j,k) + term1)
                 -(phiy(i+1,j,k)+phiy(i-1,j,k))*term2
@@ -125,12 +115,8 @@ void stag_applyop_visc_p1 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
 
             Lphiz(i,j,k) = phiz(i,j,k)*(theta_alpha*alphaz(i,j,k) + term1)
                 -(phiz(i+1,j,k)+phiz(i-1,j,k))*term2
@@ -198,8 +184,6 @@ void stag_applyop_visc_m1 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
-
     Real dxsqinv = 1./(dx[0]*dx[0]);
     Real dysqinv = 1./(dx[1]*dx[1]);
 #if (AMREX_SPACEDIM == 3)
@@ -210,12 +194,8 @@ void stag_applyop_visc_m1 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
             Lphix(i,j,k) = phix(i,j,k)*
                 (theta_alpha*alphax(i,j,k)
                  +(betacc(i,j,k)+betacc(i-1,j,k))*dxsqinv
@@ -239,12 +219,8 @@ void stag_applyop_visc_m1 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
             Lphiy(i,j,k) = phiy(i,j,k)*
                 (theta_alpha*alphay(i,j,k)
                  +(betacc(i,j,k)+betacc(i,j-1,k))*dysqinv
@@ -269,12 +245,8 @@ void stag_applyop_visc_m1 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
             Lphiz(i,j,k) = phiz(i,j,k)*
                 (theta_alpha*alphaz(i,j,k)
                  +(betacc(i,j,k)+betacc(i,j,k-1))*dzsqinv
@@ -339,8 +311,6 @@ void stag_applyop_visc_p2 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
-
     Real dxsqinv = 1./(dx[0]*dx[0]);
     Real dysqinv = 1./(dx[1]*dx[1]);
     Real dxdyinv = 1./(dx[0]*dx[1]);
@@ -360,12 +330,8 @@ void stag_applyop_visc_p2 (Box const& tbx,
     
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
             Lphix(i,j,k) = phix(i,j,k)*(theta_alpha*alphax(i,j,k) + term1)
                 -bt*( (phix(i+1,j,k)+phix(i-1,j,k))*2.*dxsqinv
                       +(phix(i,j+1,k)+phix(i,j-1,k))*dysqinv
@@ -390,12 +356,8 @@ void stag_applyop_visc_p2 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
             Lphiy(i,j,k) = phiy(i,j,k)*( theta_alpha*alphay(i,j,k) + term1)
                 -bt*( (phiy(i,j+1,k)+phiy(i,j-1,k))*2.*dysqinv
                       +(phiy(i+1,j,k)+phiy(i-1,j,k))*dxsqinv
@@ -417,12 +379,8 @@ void stag_applyop_visc_p2 (Box const& tbx,
         
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
             Lphiz(i,j,k) = phiz(i,j,k)*( theta_alpha*alphaz(i,j,k) + term1)
                 -bt*( (phiz(i,j,k+1)+phiz(i,j,k-1))*2.*dzsqinv
                       +(phiz(i+1,j,k)+phiz(i-1,j,k))*dxsqinv
@@ -491,8 +449,6 @@ void stag_applyop_visc_m2 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
-
     Real dxsqinv = 1./(dx[0]*dx[0]);
     Real dysqinv = 1./(dx[1]*dx[1]);
     Real dxdyinv = 1./(dx[0]*dx[1]);
@@ -506,12 +462,8 @@ void stag_applyop_visc_m2 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
                    
             Lphix(i,j,k) = phix(i,j,k)*
                 ( theta_alpha*alphax(i,j,k) +
@@ -552,12 +504,8 @@ void stag_applyop_visc_m2 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
                    
             Lphiy(i,j,k) = phiy(i,j,k)*
                 ( theta_alpha*alphay(i,j,k) +
@@ -599,12 +547,8 @@ void stag_applyop_visc_m2 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
 
             Lphiz(i,j,k) = phiz(i,j,k)*
                 ( theta_alpha*alphaz(i,j,k) +
@@ -681,10 +625,20 @@ void StagApplyOp(const Geometry & geom,
         offset = 2;
     }
 #endif
+    else if (color == 2*AMREX_SPACEDIM+1 || color == 2*AMREX_SPACEDIM+2) {
+        // red-black over all face directions at once (stag_mg_smoother = 2)
+        AMREX_D_TERM(do_x = true;,
+                     do_y = true;,
+                     do_z = true;);
+        offset = 2;
+    }
     else {
         Abort("StagApplyOp: Invalid Color");
     }
 
+    // for the red-black colors Lphi is evaluated on both colors of the selected directions,
+    // in unit-stride loops; StagMGUpdate only applies it on the faces of the color
+
     // Loop over boxes (make sure mfi takes a cell-centered multifab as an argument)
     for (MFIter mfi(beta_cc,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
 
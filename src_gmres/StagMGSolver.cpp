@@ -16,10 +16,19 @@ void StagMGSolver::Define(const BoxArray& ba_in,
     ba_base = ba_in;
     
     dmap = dmap_in;    
+
+    // coarsened coefficients are rebuilt on the first call to Solve
+    coeffs_cached = false;
     
     // compute the number of multigrid levels assuming stag_mg_minwidth is the length of the
     // smallest dimension of the smallest grid at the coarsest multigrid level
     nlevs_mg = ComputeNlevsMG(ba_base);
+
+    // the agglomerated bottom hierarchy adds at most stag_mg_max_bottom_nlevels levels
+    if (is_bottom) {
+        nlevs_mg = amrex::min(nlevs_mg, stag_mg_max_bottom_nlevels+1);
+    }
+
     if (stag_mg_verbosity >= 3) {
         Print() << "Total number of multigrid levels: " << nlevs_mg << std::endl;
     }
@@ -27,6 +36,7 @@ void StagMGSolver::Define(const BoxArray& ba_in,
     alpha_fc_mg.resize(nlevs_mg);
     rhs_fc_mg.resize(nlevs_mg);
     phi_fc_mg.resize(nlevs_mg);
+    phi_pack_mg.resize(nlevs_mg);
     Lphi_fc_mg.resize(nlevs_mg);
     resid_fc_mg.resize(nlevs_mg);
     beta_ed_mg.resize(nlevs_mg);
@@ -85,6 +95,22 @@ void StagMGSolver::Define(const BoxArray& ba_in,
             phi_fc_mg[n][d].setVal(0);
         }
 
+        // all face components of phi on the cell-centered grids, for exchanging their
+        // ghost cells together; the x-faces i = lo..hi+1 of a grid need cells lo-1..hi+2,
+        // so it has one more ghost cell than phi, and grids on a non-periodic high
+        // boundary are extended by one cell to hold the faces on that boundary
+        BoxList bl_pack(ba);
+        for (Box& b : bl_pack) {
+            for (int d=0; d<AMREX_SPACEDIM; ++d) {
+                if (!geom_mg[n].isPeriodic(d) && b.bigEnd(d) == pd.bigEnd(d)) {
+                    b.growHi(d,1);
+                }
+            }
+        }
+        phi_pack_mg[n].define(BoxArray(std::move(bl_pack)), dmap, AMREX_SPACEDIM,
+                              phi_fc_mg[n][0].nGrow()+1);
+        phi_pack_mg[n].setVal(0);
+
         // build beta_ed_mg
         if (AMREX_SPACEDIM == 2) {
             beta_ed_mg[n][0].define(convert(ba, nodal_flag), dmap, 1, 0);
@@ -94,10 +120,190 @@ void StagMGSolver::Define(const BoxArray& ba_in,
                 beta_ed_mg[n][d].define(convert(ba, nodal_flag_edge[d]), dmap, 1, 0);
         }
     } // end loop over multigrid levels
+
+    // stag_mg_bottom_solver = 4: gather the coarsest level onto a single grid owned
+    // by one rank, where it can be coarsened further than the many small grids allow
+    bottom_solver.reset();
+    if (stag_mg_bottom_solver == 4 && !is_bottom && ba_base.size() > 1) {
+
+        Box pd_bottom(pd_base);
+        pd_bottom.coarsen(pow(2,nlevs_mg-1));
+
+        BoxArray ba_bottom(pd_bottom);
+        DistributionMapping dmap_bottom(ba_bottom);
+
+        Geometry geom_bottom(pd_bottom,&real_box,CoordSys::cartesian,is_periodic.data());
+
+        bottom_solver.reset(new StagMGSolver());
+        bottom_solver->is_bottom = true;
+        bottom_solver->Define(ba_bottom,dmap_bottom,geom_bottom);
+
+        // coefficients and solution on the agglomerated grid
+        beta_cc_bottom .define(ba_bottom, dmap_bottom, 1, 1);
+        gamma_cc_bottom.define(ba_bottom, dmap_bottom, 1, 1);
+        for (int d=0; d<AMREX_SPACEDIM; d++) {
+            alpha_fc_bottom[d].define(convert(ba_bottom, nodal_flag_dir[d]), dmap_bottom, 1, 0);
+              rhs_fc_bottom[d].define(convert(ba_bottom, nodal_flag_dir[d]), dmap_bottom, 1, 0);
+              phi_fc_bottom[d].define(convert(ba_bottom, nodal_flag_dir[d]), dmap_bottom, 1, 1);
+        }
+#if (AMREX_SPACEDIM == 2)
+        beta_ed_bottom[0].define(convert(ba_bottom, nodal_flag), dmap_bottom, 1, 0);
+#elif (AMREX_SPACEDIM == 3)
+        for (int d=0; d<AMREX_SPACEDIM; d++) {
+            beta_ed_bottom[d].define(convert(ba_bottom, nodal_flag_edge[d]), dmap_bottom, 1, 0);
+        }
+#endif
+
+        if (stag_mg_verbosity >= 3) {
+            Print() << "Agglomerated bottom solver with "
+                    << bottom_solver->nlevs_mg << " levels" << std::endl;
+        }
+    }
     
 }
 
 
+// returns true if any of the coefficients differ from the level 0 copies
+// currently held in the multigrid hierarchy
+bool StagMGSolver::CoefficientsChanged(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
+                                       const MultiFab & beta_cc,
+                                       const std::array<MultiFab, NUM_EDGE> & beta_ed,
+                                       const MultiFab & gamma_cc,
+                                       const Real & theta_alpha)
+{
+    BL_PROFILE_VAR("StagMGSolver::CoefficientsChanged()",StagMGSolver_CoefficientsChanged);
+
+    ReduceOps<ReduceOpMax> reduce_op;
+    ReduceData<int> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+    // compare src*scale against dst over the valid region grown by ngrow
+    auto compare = [&] (const MultiFab& src, const MultiFab& dst, Real scale, int ngrow)
+    {
+        for (MFIter mfi(dst,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+            const Box& bx = mfi.growntilebox(ngrow);
+
+            const Array4<Real const> & s = src.array(mfi);
+            const Array4<Real const> & d = dst.array(mfi);
+
+            reduce_op.eval(bx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                return {(s(i,j,k)*scale != d(i,j,k)) ? 1 : 0};
+            });
+        }
+    };
+
+    compare( beta_cc,  beta_cc_mg[0], 1., 1);
+    compare(gamma_cc, gamma_cc_mg[0], 1., 1);
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        compare(alpha_fc[d], alpha_fc_mg[0][d], theta_alpha, 0);
+    }
+    for (int d=0; d<NUM_EDGE; ++d) {
+        compare(beta_ed[d], beta_ed_mg[0][d], 1., 0);
+    }
+
+    int changed = amrex::get<0>(reduce_data.value());
+    ParallelDescriptor::ReduceIntMax(changed);
+
+    if (stag_mg_verbosity >= 3 && changed == 0) {
+        Print() << "Reusing coarsened multigrid coefficients" << std::endl;
+    }
+
+    return (changed != 0);
+}
+
+// copy the coefficients into level 0 of the multigrid hierarchy and coarsen them
+// to the other levels (and onto the agglomerated bottom grid, if used)
+void StagMGSolver::SetCoefficients(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
+                                   const MultiFab & beta_cc,
+                                   const std::array<MultiFab, NUM_EDGE> & beta_ed,
+                                   const MultiFab & gamma_cc,
+                                   const Real & theta_alpha)
+{
+    BL_PROFILE_VAR("StagMGSolver::SetCoefficients()",StagMGSolver_SetCoefficients);
+
+    // the coarsened coefficients only need to be rebuilt when the level 0
+    // coefficients or theta_alpha differ from the ones used in the previous call,
+    // e.g., across timesteps when the coefficients are constant
+    if (!coeffs_cached ||
+        CoefficientsChanged(alpha_fc,beta_cc,beta_ed,gamma_cc,theta_alpha)) {
+
+        // copy level 1 coefficients into mg array of coefficients
+        MultiFab::Copy(beta_cc_mg[0],  beta_cc,  0, 0, 1, 1);
+        MultiFab::Copy(gamma_cc_mg[0], gamma_cc, 0, 0, 1, 1);
+
+        for (int d=0; d<AMREX_SPACEDIM; ++d) {
+            MultiFab::Copy(alpha_fc_mg[0][d], alpha_fc[d], 0, 0, 1, 0);
+            // multiply alpha_fc_mg by theta_alpha
+            alpha_fc_mg[0][d].mult(theta_alpha,0,1,0);
+        }
+
+        MultiFab::Copy(    beta_ed_mg[0][0], beta_ed[0], 0, 0, 1, 0);
+        if (AMREX_SPACEDIM == 3) {
+            MultiFab::Copy(beta_ed_mg[0][1], beta_ed[1], 0, 0, 1, 0);
+            MultiFab::Copy(beta_ed_mg[0][2], beta_ed[2], 0, 0, 1, 0);
+        }
+
+        // coarsen coefficients
+        for (int n=1; n<nlevs_mg; ++n) {
+            // need ghost cells set to zero to prevent intermediate NaN states
+            // that cause some compilers to fail
+             beta_cc_mg[n].setVal(0.);
+            gamma_cc_mg[n].setVal(0.);
+
+            // cc_restriction on beta_cc_mg and gamma_cc_mg
+            // NOTE: CCRestriction calls FillBoundary
+
+            CCRestriction( beta_cc_mg[n],  beta_cc_mg[n-1], geom_mg[n]);
+            CCRestriction(gamma_cc_mg[n], gamma_cc_mg[n-1], geom_mg[n]);
+
+            // stag_restriction on alpha_fc_mg
+            StagRestriction(alpha_fc_mg[n], alpha_fc_mg[n-1], 1);
+
+            // NOTE: StagRestriction, NodalRestriction, and EdgeRestriction do not
+            // call FillBoundary => Do them here for now
+
+            for (int d=0; d<AMREX_SPACEDIM; d++) {
+                alpha_fc_mg[n][d].FillBoundary(geom_mg[n].periodicity());
+            }
+
+#if (AMREX_SPACEDIM == 2)
+            // nodal_restriction on beta_ed_mg
+            NodalRestriction(beta_ed_mg[n][0],beta_ed_mg[n-1][0]);
+#elif (AMREX_SPACEDIM == 3)
+            // edge_restriction on beta_ed_mg
+            EdgeRestriction(beta_ed_mg[n],beta_ed_mg[n-1]);
+#endif
+        }
+
+        // copy the coarsest coefficients onto the agglomerated grid
+        if (bottom_solver) {
+            int n = nlevs_mg-1;
+
+            beta_cc_bottom.setVal(0.);
+            gamma_cc_bottom.setVal(0.);
+            beta_cc_bottom.ParallelCopy(beta_cc_mg[n],0,0,1);
+            gamma_cc_bottom.ParallelCopy(gamma_cc_mg[n],0,0,1);
+            beta_cc_bottom.FillBoundary(bottom_solver->geom_mg[0].periodicity());
+            gamma_cc_bottom.FillBoundary(bottom_solver->geom_mg[0].periodicity());
+
+            for (int d=0; d<AMREX_SPACEDIM; d++) {
+                alpha_fc_bottom[d].ParallelCopy(alpha_fc_mg[n][d],0,0,1);
+            }
+            for (int d=0; d<NUM_EDGE; d++) {
+                beta_ed_bottom[d].ParallelCopy(beta_ed_mg[n][d],0,0,1);
+            }
+
+            bottom_solver->SetCoefficients(alpha_fc_bottom,beta_cc_bottom,beta_ed_bottom,
+                                           gamma_cc_bottom,1.);
+        }
+
+        coeffs_cached = true;
+    }
+}
+
 // solve "(theta*alpha*I - L) phi = rhs" using multigrid with Gauss-Seidel relaxation
 // if amrex::Math::abs(visc_type) = 1, L = div beta grad
 // if amrex::Math::abs(visc_type) = 2, L = div [ beta (grad + grad^T) ]
@@ -114,7 +320,8 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
                          const MultiFab & gamma_cc,
                          std::array<MultiFab, AMREX_SPACEDIM> & phi_fc,
                          const std::array<MultiFab, AMREX_SPACEDIM> & rhs_fc,
-                         const Real & theta_alpha)
+                         const Real & theta_alpha,
+                         bool coeffs_set)
 {
     BL_PROFILE_VAR("StagMGSolver::Solve()",StagMGSolver_Solve);
 
@@ -131,52 +338,9 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
 
     int n, color_start, color_end;
 
-    // copy level 1 coefficients into mg array of coefficients
-    MultiFab::Copy(beta_cc_mg[0],  beta_cc,  0, 0, 1, 1);
-    MultiFab::Copy(gamma_cc_mg[0], gamma_cc, 0, 0, 1, 1);
-
-    for (int d=0; d<AMREX_SPACEDIM; ++d) {
-        MultiFab::Copy(alpha_fc_mg[0][d], alpha_fc[d], 0, 0, 1, 0);
-        // multiply alpha_fc_mg by theta_alpha
-        alpha_fc_mg[0][d].mult(theta_alpha,0,1,0);
-    }
-
-    MultiFab::Copy(    beta_ed_mg[0][0], beta_ed[0], 0, 0, 1, 0);
-    if (AMREX_SPACEDIM == 3) {
-        MultiFab::Copy(beta_ed_mg[0][1], beta_ed[1], 0, 0, 1, 0);
-        MultiFab::Copy(beta_ed_mg[0][2], beta_ed[2], 0, 0, 1, 0);
-    }
-
-    // coarsen coefficients
-    for (n=1; n<nlevs_mg; ++n) {
-        // need ghost cells set to zero to prevent intermediate NaN states
-        // that cause some compilers to fail
-         beta_cc_mg[n].setVal(0.);
-        gamma_cc_mg[n].setVal(0.);
-
-        // cc_restriction on beta_cc_mg and gamma_cc_mg
-        // NOTE: CCRestriction calls FillBoundary
-
-        CCRestriction( beta_cc_mg[n],  beta_cc_mg[n-1], geom_mg[n]);
-        CCRestriction(gamma_cc_mg[n], gamma_cc_mg[n-1], geom_mg[n]);
-
-        // stag_restriction on alpha_fc_mg
-        StagRestriction(alpha_fc_mg[n], alpha_fc_mg[n-1], 1);
-
-        // NOTE: StagRestriction, NodalRestriction, and EdgeRestriction do not
-        // call FillBoundary => Do them here for now
-
-        for (int d=0; d<AMREX_SPACEDIM; d++) {
-            alpha_fc_mg[n][d].FillBoundary(geom_mg[n].periodicity());
-        }
-
-#if (AMREX_SPACEDIM == 2)
-        // nodal_restriction on beta_ed_mg
-        NodalRestriction(beta_ed_mg[n][0],beta_ed_mg[n-1][0]);
-#elif (AMREX_SPACEDIM == 3)
-        // edge_restriction on beta_ed_mg
-        EdgeRestriction(beta_ed_mg[n],beta_ed_mg[n-1]);
-#endif
+    // push the coefficients to all multigrid levels, unless the caller already did
+    if (!coeffs_set) {
+        SetCoefficients(alpha_fc,beta_cc,beta_ed,gamma_cc,theta_alpha);
     }
 
     /*!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
@@ -236,15 +400,28 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
     }
 
     if (stag_mg_smoother == 0) {
+        // Jacobi; all components at once
         color_start = 0;
         color_end = 0;
     }
-    else {
+    else if (stag_mg_smoother == 1) {
+        // red-black Gauss-Seidel, one face direction per color
         color_start = 1;
         color_end = 2*AMREX_SPACEDIM;
     }
+    else if (stag_mg_smoother == 2) {
+        // red-black Gauss-Seidel, all face directions per color
+        color_start = 2*AMREX_SPACEDIM+1;
+        color_end = 2*AMREX_SPACEDIM+2;
+    }
+    else {
+        Abort("StagMGSolver::Solve: invalid stag_mg_smoother");
+    }
 
-    for (int vcycle=1; vcycle<=stag_mg_max_vcycles; ++vcycle) {
+    // the agglomerated bottom hierarchy is cheap to cycle, so it iterates further
+    const int max_vcycles = is_bottom ? stag_mg_max_bottom_vcycles : stag_mg_max_vcycles;
+
+    for (int vcycle=1; vcycle<=max_vcycles; ++vcycle) {
 
         if (stag_mg_verbosity >= 2) {
             Print() << "Begin V-Cycle " << vcycle << std::endl;
@@ -294,17 +471,8 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
                     StagMGUpdate(phi_fc_mg[n],rhs_fc_mg[n],Lphi_fc_mg[n],alpha_fc_mg[n],
                                  beta_cc_mg[n],beta_ed_mg[n],gamma_cc_mg[n],dx_mg[n].data(),color);
 
-                    for (int d=0; d<AMREX_SPACEDIM; ++d) {
-
-                        // set values on physical boundaries
-                        MultiFabPhysBCDomainVel(phi_fc_mg[n][d], geom_mg[n],d);
-
-                        // fill periodic ghost cells
-                        phi_fc_mg[n][d].FillBoundary(geom_mg[n].periodicity());
-
-                        // fill physical ghost cells
-                        MultiFabPhysBCMacVel(phi_fc_mg[n][d], geom_mg[n],d);
-                    }
+                    // fill ghost cells of the components updated by this color
+                    StagMGFillBoundary(n,color);
 
                 } // end loop over colors
 
@@ -373,8 +541,32 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
             Print() << "Begin bottom solve" << std::endl;
         }
 
+        if (bottom_solver) {
+
+            ////////////////////////////
+            // solve on the agglomerated grid; the coefficients there were set
+            // when the coarsened coefficients were built
+
+            for (int d=0; d<AMREX_SPACEDIM; d++) {
+                rhs_fc_bottom[d].ParallelCopy(rhs_fc_mg[n][d],0,0,1);
+                phi_fc_bottom[d].setVal(0.);
+                phi_fc_bottom[d].ParallelCopy(phi_fc_mg[n][d],0,0,1);
+            }
+
+            bottom_solver->Solve(alpha_fc_bottom,beta_cc_bottom,beta_ed_bottom,gamma_cc_bottom,
+                                 phi_fc_bottom,rhs_fc_bottom,1.,true);
+
+            for (int d=0; d<AMREX_SPACEDIM; d++) {
+                phi_fc_mg[n][d].ParallelCopy(phi_fc_bottom[d],0,0,1);
+            }
+
+            // fill ghost cells of all components
+            StagMGFillBoundary(n);
+        }
+
         ////////////////////////////
-        // just do smooths at the current level as the bottom solve
+        // otherwise just do smooths at the current level as the bottom solve
+        const int nsmooths_bottom = bottom_solver ? 0 : stag_mg_nsmooths_bottom;
 
         // print out residual
         if (stag_mg_verbosity >= 3) {
@@ -394,7 +586,7 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
             }
         }
 
-        for (int m=1; m<=stag_mg_nsmooths_bottom; ++m) {
+        for (int m=1; m<=nsmooths_bottom; ++m) {
 
             // do the smooths
             for (int color=color_start; color<=color_end; ++color) {
@@ -411,17 +603,8 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
                 StagMGUpdate(phi_fc_mg[n],rhs_fc_mg[n],Lphi_fc_mg[n],alpha_fc_mg[n],
                              beta_cc_mg[n],beta_ed_mg[n],gamma_cc_mg[n],dx_mg[n].data(),color);
 
-                for (int d=0; d<AMREX_SPACEDIM; d++) {
-
-                    // set values on physical boundaires
-                    MultiFabPhysBCDomainVel(phi_fc_mg[n][d], geom_mg[n],d);
-
-                    // fill periodic ghost cells
-                    phi_fc_mg[n][d].FillBoundary(geom_mg[n].periodicity());
-
-                    // fill physical ghost cells
-                    MultiFabPhysBCMacVel(phi_fc_mg[n][d], geom_mg[n],d);
-                }
+                // fill ghost cells of the components updated by this color
+                StagMGFillBoundary(n,color);
 
             } // end loop over colors
 
@@ -466,17 +649,8 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
             // prolongate/interpolate correction to update phi
             StagProlongation(phi_fc_mg[n+1],phi_fc_mg[n]);
 
-            for (int d=0; d<AMREX_SPACEDIM; ++d) {
-
-                // set values on physical boundaries
-                MultiFabPhysBCDomainVel(phi_fc_mg[n][d], geom_mg[n],d);
-
-                // fill periodic ghost cells
-                phi_fc_mg[n][d].FillBoundary(geom_mg[n].periodicity());
-
-                // fill physical ghost cells
-                MultiFabPhysBCMacVel(phi_fc_mg[n][d], geom_mg[n],d);
-            }
+            // fill ghost cells of all components
+            StagMGFillBoundary(n);
 
             // print out residual
             if (stag_mg_verbosity >= 3) {
@@ -512,17 +686,8 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
                     StagMGUpdate(phi_fc_mg[n],rhs_fc_mg[n],Lphi_fc_mg[n],alpha_fc_mg[n],
                                  beta_cc_mg[n],beta_ed_mg[n],gamma_cc_mg[n],dx_mg[n].data(),color);
 
-                    for (int d=0; d<AMREX_SPACEDIM; d++) {
-
-                        // set values on physical boundaries
-                        MultiFabPhysBCDomainVel(phi_fc_mg[n][d], geom_mg[n],d);
-
-                        // fill periodic ghost cells
-                        phi_fc_mg[n][d].FillBoundary(geom_mg[n].periodicity());
-
-                        // fill physical ghost cells
-                        MultiFabPhysBCMacVel(phi_fc_mg[n][d], geom_mg[n],d);
-                    }
+                    // fill ghost cells of the components updated by this color
+                    StagMGFillBoundary(n,color);
 
                 } // end loop over colors
 
@@ -619,7 +784,7 @@ void StagMGSolver::Solve(const std::array<MultiFab, AMREX_SPACEDIM> & alpha_fc,
 	    break;
         }
 
-        if (vcycle == stag_mg_max_vcycles) {
+        if (vcycle == max_vcycles) {
             if (stag_mg_verbosity >= 1) {
                 Print() << "Exiting staggered multigrid; maximum number of V-Cycles reached" << std::endl;
                 for (int d=0; d<AMREX_SPACEDIM; ++d) {
@@ -1043,6 +1208,14 @@ void StagMGSolver::StagProlongation(const std::array< MultiFab, AMREX_SPACEDIM >
     }
 }
 
+// the red-black colors (offset = 2) update the faces whose i+j+k has the parity of color+1;
+// the smoother loops visit every face of a row and select, so they stay unit-stride and vectorize
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+bool stag_mg_in_color (int i, int j, int k, int offset, int color) noexcept
+{
+    return offset == 1 || ((i+j+k+color+1) & 1) == 0;
+}
+
 AMREX_GPU_HOST_DEVICE
 inline
 void stag_mg_update_visc_p1 (Box const& tbx,
@@ -1094,7 +1267,6 @@ void stag_mg_update_visc_p1 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
     Real fac;
     Real dxsqinv = 1./(dx[0]*dx[0]);
 
@@ -1102,14 +1274,10 @@ void stag_mg_update_visc_p1 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
             fac = alphax(i,j,k) + 2.*AMREX_SPACEDIM*b * dxsqinv;
-            phix(i,j,k) = phix(i,j,k) + stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac;
+            phix(i,j,k) = phix(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1119,14 +1287,10 @@ void stag_mg_update_visc_p1 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
             fac = alphay(i,j,k) + 2.*AMREX_SPACEDIM*b * dxsqinv;
-            phiy(i,j,k) = phiy(i,j,k) + stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac;
+            phiy(i,j,k) = phiy(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1137,14 +1301,10 @@ void stag_mg_update_visc_p1 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
             fac = alphaz(i,j,k) + 2.*AMREX_SPACEDIM*b * dxsqinv;
-            phiz(i,j,k) = phiz(i,j,k) + stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac;
+            phiz(i,j,k) = phiz(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1210,7 +1370,6 @@ void stag_mg_update_visc_m1 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
     Real fac;
     Real dxsqinv = 1./(dx[0]*dx[0]);
 
@@ -1218,12 +1377,8 @@ void stag_mg_update_visc_m1 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
 
             fac = alphax(i,j,k) +
                 ( beta(i,j,k)+beta(i-1,j,k)
@@ -1233,7 +1388,7 @@ void stag_mg_update_visc_m1 (Box const& tbx,
 #endif
                     ) * dxsqinv;
 
-                phix(i,j,k) = phix(i,j,k) + stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac;
+                phix(i,j,k) = phix(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1243,12 +1398,8 @@ void stag_mg_update_visc_m1 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
 
             fac = alphay(i,j,k) +
                 ( beta(i,j,k)+beta(i,j-1,k)
@@ -1258,7 +1409,7 @@ void stag_mg_update_visc_m1 (Box const& tbx,
 #endif
                     ) * dxsqinv;
 
-            phiy(i,j,k) = phiy(i,j,k) + stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac;
+            phiy(i,j,k) = phiy(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac : 0.);
 
         }
         }
@@ -1270,19 +1421,15 @@ void stag_mg_update_visc_m1 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
 
             fac = alphaz(i,j,k) +
                 ( beta(i,j,k)+beta(i,j,k-1)
                   +beta_xz(i,j,k)+beta_xz(i+1,j,k)
                   +beta_yz(i,j,k)+beta_yz(i,j+1,k) ) * dxsqinv;
 
-            phiz(i,j,k) = phiz(i,j,k) + stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac;
+            phiz(i,j,k) = phiz(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac : 0.);
 
         }
         }
@@ -1343,7 +1490,6 @@ void stag_mg_update_visc_p2 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
     Real fac;
     Real dxsqinv = 1./(dx[0]*dx[0]);
 
@@ -1351,14 +1497,10 @@ void stag_mg_update_visc_p2 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
             fac = alphax(i,j,k) + 2.*(1.+AMREX_SPACEDIM)*b * dxsqinv;
-            phix(i,j,k) = phix(i,j,k) + stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac;
+            phix(i,j,k) = phix(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1368,14 +1510,10 @@ void stag_mg_update_visc_p2 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
             fac = alphay(i,j,k) + 2.*(1.+AMREX_SPACEDIM)*b * dxsqinv;
-            phiy(i,j,k) = phiy(i,j,k) + stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac  ;
+            phiy(i,j,k) = phiy(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1386,14 +1524,10 @@ void stag_mg_update_visc_p2 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
             fac = alphaz(i,j,k) + 2.*(1.+AMREX_SPACEDIM)*b * dxsqinv;
-            phiz(i,j,k) = phiz(i,j,k) + stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac;
+            phiz(i,j,k) = phiz(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1459,7 +1593,6 @@ void stag_mg_update_visc_m2 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
     Real fac;
     Real dxsqinv = 1./(dx[0]*dx[0]);
 
@@ -1467,12 +1600,8 @@ void stag_mg_update_visc_m2 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
             fac = alphax(i,j,k) +
                 ( 2.*beta(i,j,k)+2.*beta(i-1,j,k)
                   +beta_xy(i,j,k)+beta_xy(i,j+1,k)
@@ -1480,7 +1609,7 @@ void stag_mg_update_visc_m2 (Box const& tbx,
                   +beta_xz(i,j,k)+beta_xz(i,j,k+1)
 #endif
                     ) * dxsqinv;
-            phix(i,j,k) = phix(i,j,k) + stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac;
+            phix(i,j,k) = phix(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1490,12 +1619,8 @@ void stag_mg_update_visc_m2 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
             fac = alphay(i,j,k) +
                 ( 2.*beta(i,j,k)+2.*beta(i,j-1,k)
                   +beta_xy(i,j,k)+beta_xy(i+1,j,k)
@@ -1503,7 +1628,7 @@ void stag_mg_update_visc_m2 (Box const& tbx,
                   +beta_yz(i,j,k)+beta_yz(i,j,k+1)
 #endif
                     ) * dxsqinv;
-            phiy(i,j,k) = phiy(i,j,k) + stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac;
+            phiy(i,j,k) = phiy(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1514,17 +1639,13 @@ void stag_mg_update_visc_m2 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
             fac = alphaz(i,j,k) +
                 ( 2.*beta(i,j,k)+2.*beta(i,j,k-1)
                   +beta_xz(i,j,k)+beta_xz(i+1,j,k)
                   +beta_yz(i,j,k)+beta_yz(i,j+1,k) ) * dxsqinv;
-            phiz(i,j,k) = phiz(i,j,k) + stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac;
+            phiz(i,j,k) = phiz(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1584,7 +1705,6 @@ void stag_mg_update_visc_p3 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
     Real fac;
     Real dxsqinv = 1./(dx[0]*dx[0]);
     Real fac2 = (AMREX_SPACEDIM == 2) ? 14./3. : 20./3.;
@@ -1593,14 +1713,10 @@ void stag_mg_update_visc_p3 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
             fac = alphax(i,j,k)+(fac2*b+2.*c) * dxsqinv;
-            phix(i,j,k) = phix(i,j,k) + stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac;
+            phix(i,j,k) = phix(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1610,14 +1726,10 @@ void stag_mg_update_visc_p3 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
             fac = alphay(i,j,k)+(fac2*b+2.*c) * dxsqinv;
-            phiy(i,j,k) = phiy(i,j,k) + stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac;
+            phiy(i,j,k) = phiy(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1628,14 +1740,10 @@ void stag_mg_update_visc_p3 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
             fac = alphaz(i,j,k)+(fac2*b+2.*c) * dxsqinv;
-            phiz(i,j,k) = phiz(i,j,k) + stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac;
+            phiz(i,j,k) = phiz(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1702,7 +1810,6 @@ void stag_mg_update_visc_m3 (Box const& tbx,
                  const auto yhi = amrex::elemwiseMin(thi, ubound(ybx));,
                  const auto zhi = amrex::elemwiseMin(thi, ubound(zbx)););
 
-    int ioff;
     Real fac;
     Real dxsqinv = 1./(dx[0]*dx[0]);
     Real fourthirds = 4./3.;
@@ -1711,12 +1818,8 @@ void stag_mg_update_visc_m3 (Box const& tbx,
 
         for (int k = xlo.z; k <= xhi.z; ++k) {
         for (int j = xlo.y; j <= xhi.y; ++j) {
-        ioff = 0;
-	if (offset == 2 && (xlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = xlo.x+ioff; i <= xhi.x; i+=offset) {
+        for (int i = xlo.x; i <= xhi.x; ++i) {
 
                    fac = alphax(i,j,k) +
                         ( fourthirds*beta(i,j,k)+gamma(i,j,k)
@@ -1727,7 +1830,7 @@ void stag_mg_update_visc_m3 (Box const& tbx,
 #endif
                             ) * dxsqinv;
 
-                   phix(i,j,k) = phix(i,j,k) + stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac;
+                   phix(i,j,k) = phix(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsx(i,j,k)-Lpx(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1737,12 +1840,8 @@ void stag_mg_update_visc_m3 (Box const& tbx,
 
         for (int k = ylo.z; k <= yhi.z; ++k) {
         for (int j = ylo.y; j <= yhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (ylo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = ylo.x+ioff; i <= yhi.x; i+=offset) {
+        for (int i = ylo.x; i <= yhi.x; ++i) {
 
                    fac = alphay(i,j,k) +
                         ( fourthirds*beta(i,j,k)+gamma(i,j,k)
@@ -1753,7 +1852,7 @@ void stag_mg_update_visc_m3 (Box const& tbx,
 #endif
                             ) * dxsqinv;
 
-                   phiy(i,j,k) = phiy(i,j,k) + stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac;
+                   phiy(i,j,k) = phiy(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsy(i,j,k)-Lpy(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1764,12 +1863,8 @@ void stag_mg_update_visc_m3 (Box const& tbx,
 
         for (int k = zlo.z; k <= zhi.z; ++k) {
         for (int j = zlo.y; j <= zhi.y; ++j) {
-        ioff = 0;
-        if (offset == 2 && (zlo.x+j+k)%2 != (color+1)%2 ) {
-	  ioff = 1;
-	}
         AMREX_PRAGMA_SIMD
-        for (int i = zlo.x+ioff; i <= zhi.x; i+=offset) {
+        for (int i = zlo.x; i <= zhi.x; ++i) {
 
                    fac = alphaz(i,j,k) +
                         ( fourthirds*beta(i,j,k)+gamma(i,j,k)
@@ -1777,7 +1872,7 @@ void stag_mg_update_visc_m3 (Box const& tbx,
                         +beta_xz(i,j,k)+beta_xz(i+1,j,k)
                         +beta_yz(i,j,k)+beta_yz(i,j+1,k) ) * dxsqinv;
 
-                   phiz(i,j,k) = phiz(i,j,k) + stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac;
+                   phiz(i,j,k) = phiz(i,j,k) + (stag_mg_in_color(i,j,k,offset,color) ? stag_mg_omega*(rhsz(i,j,k)-Lpz(i,j,k)) / fac : 0.);
         }
         }
         }
@@ -1786,6 +1881,104 @@ void stag_mg_update_visc_m3 (Box const& tbx,
 
 }
 
+// apply physical and periodic boundary conditions to the face-centered
+// components of phi_fc_mg[n] touched by a smoother color (all components for
+// color 0 or the all-direction red/black colors)
+void StagMGSolver::StagMGFillBoundary(const int & n,
+                                      const int & color)
+{
+    BL_PROFILE_VAR("StagMGFillBoundary()",StagMGFillBoundary);
+
+    std::array<MultiFab, AMREX_SPACEDIM> & phi_fc = phi_fc_mg[n];
+    const Geometry & geom = geom_mg[n];
+
+    int dlo = 0;
+    int dhi = AMREX_SPACEDIM-1;
+
+    // colors 1 through 2*AMREX_SPACEDIM only update direction (color-1)/2
+    if (color >= 1 && color <= 2*AMREX_SPACEDIM) {
+        dlo = dhi = (color-1)/2;
+    }
+
+    for (int d=dlo; d<=dhi; ++d) {
+        // set values on physical boundaries
+        MultiFabPhysBCDomainVel(phi_fc[d], geom, d);
+    }
+
+    // fill periodic ghost cells
+    if (dlo == dhi) {
+        phi_fc[dlo].FillBoundary(geom.periodicity());
+    }
+    else {
+        // exchange all components in one FillBoundary of phi_pack_mg[n]:
+        // face i of direction d is stored in cell i of component d
+        MultiFab & phi_pack = phi_pack_mg[n];
+        const int ng_pack = phi_pack.nGrow();
+
+        // copy in the cells within ng_pack of the grid edges, which are the only ones sent
+        for (MFIter mfi(phi_pack); mfi.isValid(); ++mfi) {
+
+            const Box& bx = mfi.validbox();
+            const Array4<Real>& pack = phi_pack.array(mfi);
+
+            for (int d=0; d<AMREX_SPACEDIM; ++d) {
+
+                const Array4<Real const>& phi = phi_fc[d].const_array(mfi);
+                const Box& fbx = phi_fc[d].box(mfi.index());
+                const Box fbx_cc(fbx.smallEnd(), fbx.bigEnd());
+
+                for (int dd=0; dd<AMREX_SPACEDIM; ++dd) {
+
+                    Box slab_lo = bx;
+                    slab_lo.setBig(dd, bx.smallEnd(dd)+ng_pack-1);
+                    Box slab_hi = bx;
+                    slab_hi.setSmall(dd, bx.bigEnd(dd)-ng_pack+1);
+
+                    for (Box slab : {slab_lo & fbx_cc, slab_hi & fbx_cc}) {
+                        if (slab.ok()) {
+                            amrex::ParallelFor(slab, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                            {
+                                pack(i,j,k,d) = phi(i,j,k);
+                            });
+                        }
+                    }
+                }
+            }
+        }
+
+        phi_pack.FillBoundary(geom.periodicity());
+
+        // copy back the ghost faces that lie in the (periodically extended) domain,
+        // i.e., the ones a FillBoundary of phi_fc[d] would fill
+        for (int d=0; d<AMREX_SPACEDIM; ++d) {
+
+            const Box dom = amrex::convert(geom.growPeriodicDomain(phi_fc[d].nGrow()),
+                                           phi_fc[d].ixType());
+
+            for (MFIter mfi(phi_fc[d]); mfi.isValid(); ++mfi) {
+
+                const Box& vbx = mfi.validbox();
+                const Box& gbx = mfi.fabbox() & dom;
+
+                const Array4<Real>& phi = phi_fc[d].array(mfi);
+                const Array4<Real const>& pack = phi_pack.const_array(mfi);
+
+                amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    if (!vbx.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                        phi(i,j,k) = pack(i,j,k,d);
+                    }
+                });
+            }
+        }
+    }
+
+    for (int d=dlo; d<=dhi; ++d) {
+        // fill physical ghost cells
+        MultiFabPhysBCMacVel(phi_fc[d], geom, d);
+    }
+}
+
 void StagMGSolver::StagMGUpdate (std::array< MultiFab, AMREX_SPACEDIM >& phi_fc,
                                  const std::array< MultiFab, AMREX_SPACEDIM >& rhs_fc,
                                  const std::array< MultiFab, AMREX_SPACEDIM >& Lphi_fc,
@@ -1828,6 +2021,14 @@ void StagMGSolver::StagMGUpdate (std::array< MultiFab, AMREX_SPACEDIM >& phi_fc,
         offset = 2;
     }
 #endif
+    else if (color == 2*AMREX_SPACEDIM+1 || color == 2*AMREX_SPACEDIM+2) {
+        // red-black over all face directions at once (stag_mg_smoother = 2);
+        // the kernels select red/black from the parity of color
+        AMREX_D_TERM(do_x = true;,
+                     do_y = true;,
+                     do_z = true;);
+        offset = 2;
+    }
     else {
         Abort("StagMGUpdate: Invalid Color");
     }
@@ -17,6 +17,7 @@ int         gmres::mg_nsmooths_bottom;
 int         gmres::mg_max_bottom_nlevels;
 amrex::Real gmres::mg_rel_tol;
 amrex::Real gmres::mg_abs_tol;
+int         gmres::mg_precon_vcycles;
 int         gmres::stag_mg_verbosity;
 int         gmres::stag_mg_max_vcycles;
 int         gmres::stag_mg_minwidth;
@@ -25,6 +26,7 @@ int         gmres::stag_mg_nsmooths_down;
 int         gmres::stag_mg_nsmooths_up;
 int         gmres::stag_mg_nsmooths_bottom;
 int         gmres::stag_mg_max_bottom_nlevels;
+int         gmres::stag_mg_max_bottom_vcycles;
 amrex::Real gmres::stag_mg_omega;
 int         gmres::stag_mg_smoother;
 amrex::Real gmres::stag_mg_rel_tol;
@@ -35,6 +37,7 @@ int         gmres::gmres_max_outer;
 int         gmres::gmres_max_inner;
 int         gmres::gmres_max_iter;
 int         gmres::gmres_min_iter;
+int         gmres::gmres_orthog;
 int         gmres::gmres_spatial_order;
 
 void InitializeGmresNamespace() {
@@ -75,6 +78,7 @@ void InitializeGmresNamespace() {
     mg_max_bottom_nlevels = 10; // for mg_bottom_solver 4, number of additional levels of multigrid
     mg_rel_tol = 1.e-9;         // rel_tol for Poisson solve
     mg_abs_tol = 1.e-14;        // abs_tol for Poisson solve
+    mg_precon_vcycles = 0;      // if > 0, fixed number of V-cycles in the preconditioner projection
 
     // Staggered multigrid solver parameters
     stag_mg_verbosity = 0;           // verbosity
@@ -82,12 +86,15 @@ void InitializeGmresNamespace() {
     stag_mg_minwidth = 2;            // length of box at coarsest multigrid level
     stag_mg_bottom_solver = 0;       // bottom solver type
     // 0 = smooths only, controlled by mg_nsmooths_bottom
+    // 4 = agglomerate the coarsest level onto a single grid and keep coarsening
     stag_mg_nsmooths_down = 2;       // number of smooths at each level on the way down
     stag_mg_nsmooths_up = 2;         // number of smooths at each level on the way up
     stag_mg_nsmooths_bottom = 8;     // number of smooths at the bottom
     stag_mg_max_bottom_nlevels = 10; // for stag_mg_bottom_solver 4, number of additional levels of multigrid
+    stag_mg_max_bottom_vcycles = 10; // for stag_mg_bottom_solver 4, max number of v-cycles on the single grid
     stag_mg_omega = 1.;              // weightee-jacobi omega coefficient
     stag_mg_smoother = 1;            // 0 = jacobi; 1 = 2*dm-color Gauss-Seidel
+                                     // 2 = red-black Gauss-Seidel, all directions per color
     stag_mg_rel_tol = 1.e-9;         // relative tolerance stopping criteria
 
     // GMRES solver parameters
@@ -98,6 +105,8 @@ void InitializeGmresNamespace() {
     gmres_max_inner = 5;       // max number of inner iterations, or restart number
     gmres_max_iter = 100;      // max number of gmres iterations
     gmres_min_iter = 1;        // min number of gmres iterations
+    gmres_orthog = 0;          // 0 = modified Gram-Schmidt
+                               // 1 = classical Gram-Schmidt with reorthogonalization
 
     gmres_spatial_order = 2;   // spatial order of viscous and gradient operators in matrix "A"
 
@@ -122,6 +131,7 @@ void InitializeGmresNamespace() {
     pp.query("mg_max_bottom_nlevels",mg_max_bottom_nlevels);
     pp.query("mg_rel_tol",mg_rel_tol);
     pp.query("mg_abs_tol",mg_abs_tol);
+    pp.query("mg_precon_vcycles",mg_precon_vcycles);
     pp.query("stag_mg_verbosity",stag_mg_verbosity);
     pp.query("stag_mg_max_vcycles",stag_mg_max_vcycles);
     pp.query("stag_mg_minwidth",stag_mg_minwidth);
@@ -130,6 +140,7 @@ void InitializeGmresNamespace() {
     pp.query("stag_mg_nsmooths_up",stag_mg_nsmooths_up);
     pp.query("stag_mg_nsmooths_bottom",stag_mg_nsmooths_bottom);
     pp.query("stag_mg_max_bottom_nlevels",stag_mg_max_bottom_nlevels);
+    pp.query("stag_mg_max_bottom_vcycles",stag_mg_max_bottom_vcycles);
     pp.query("stag_mg_omega",stag_mg_omega);
     pp.query("stag_mg_smoother",stag_mg_smoother);
     pp.query("stag_mg_rel_tol",stag_mg_rel_tol);
@@ -140,6 +151,7 @@ void InitializeGmresNamespace() {
     pp.query("gmres_max_inner",gmres_max_inner);
     pp.query("gmres_max_iter",gmres_max_iter);
     pp.query("gmres_min_iter",gmres_min_iter);
+    pp.query("gmres_orthog",gmres_orthog);
     pp.query("gmres_spatial_order",gmres_spatial_order);
 
 }
@@ -1,14 +1,13 @@
 #include "multispec_functions.H"
 
-void ComputeMixtureProperties(const MultiFab& rho_in,
-			      const MultiFab& rhotot_in,
-			      MultiFab& D_bar_in,
-			      MultiFab& D_therm_in,
-			      MultiFab& Hessian_in)
+// instantiated for NS species by ComputeMixtureProperties (NS = 0 is generic)
+template <int NS>
+static void ComputeMixturePropertiesNS(const MultiFab& rho_in,
+                                       const MultiFab& rhotot_in,
+                                       MultiFab& D_bar_in,
+                                       MultiFab& D_therm_in,
+                                       MultiFab& Hessian_in)
 {
-
-    BL_PROFILE_VAR("ComputeMixtureProperties()",ComputeMixtureProperties);
-
     int ng = D_bar_in.nGrow();
     
     // Loop over boxes
@@ -25,6 +24,7 @@ void ComputeMixtureProperties(const MultiFab& rho_in,
         
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
 
             GpuArray<Real, MAX_SPECIES> Rho;
             Array2D<Real, 1, MAX_SPECIES, 1, MAX_SPECIES> DBar;
@@ -56,3 +56,14 @@ void ComputeMixtureProperties(const MultiFab& rho_in,
     }
 
 }
+
+void ComputeMixtureProperties(const MultiFab& rho_in,
+			      const MultiFab& rhotot_in,
+			      MultiFab& D_bar_in,
+			      MultiFab& D_therm_in,
+			      MultiFab& Hessian_in)
+{
+    BL_PROFILE_VAR("ComputeMixtureProperties()",ComputeMixtureProperties);
+
+    NSPECIES_DISPATCH(ComputeMixturePropertiesNS, rho_in, rhotot_in, D_bar_in, D_therm_in, Hessian_in);
+}
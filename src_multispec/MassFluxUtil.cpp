@@ -1,13 +1,12 @@
 #include "multispec_functions.H"
 
-void ComputeMolconcMolmtot(const MultiFab& rho_in,
-			   const MultiFab& rhotot_in,
-			   MultiFab& molarconc_in,
-			   MultiFab& molmtot_in)
+// instantiated for NS species by ComputeMolconcMolmtot (NS = 0 is generic)
+template <int NS>
+static void ComputeMolconcMolmtotNS(const MultiFab& rho_in,
+                                    const MultiFab& rhotot_in,
+                                    MultiFab& molarconc_in,
+                                    MultiFab& molmtot_in)
 {
-
-    BL_PROFILE_VAR("ComputeMolconcMolmtot()",ComputeMolconcMolmtot);
-
     int ng = molarconc_in.nGrow();
 
     // Loop over boxes
@@ -23,6 +22,7 @@ void ComputeMolconcMolmtot(const MultiFab& rho_in,
 
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
 
             GpuArray<Real, MAX_SPECIES> RhoN;
             GpuArray<Real, MAX_SPECIES> MolarConcN;
@@ -46,13 +46,22 @@ void ComputeMolconcMolmtot(const MultiFab& rho_in,
     }
 }
 
-void ComputeGamma(const MultiFab& molarconc_in,
-		      const MultiFab& Hessian_in,
-          MultiFab& Gamma_in)
+void ComputeMolconcMolmtot(const MultiFab& rho_in,
+			   const MultiFab& rhotot_in,
+			   MultiFab& molarconc_in,
+			   MultiFab& molmtot_in)
 {
+    BL_PROFILE_VAR("ComputeMolconcMolmtot()",ComputeMolconcMolmtot);
 
-    BL_PROFILE_VAR("ComputeGamma()",ComputeGamma);
+    NSPECIES_DISPATCH(ComputeMolconcMolmtotNS, rho_in, rhotot_in, molarconc_in, molmtot_in);
+}
 
+// instantiated for NS species by ComputeGamma (NS = 0 is generic)
+template <int NS>
+static void ComputeGammaNS(const MultiFab& molarconc_in,
+                           const MultiFab& Hessian_in,
+                           MultiFab& Gamma_in)
+{
     int ng = Gamma_in.nGrow();
 
     // Loop over boxes
@@ -67,6 +76,7 @@ void ComputeGamma(const MultiFab& molarconc_in,
 
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
 
             GpuArray<Real, MAX_SPECIES> MolarConcN;
             Array2D<Real, 1, MAX_SPECIES, 1, MAX_SPECIES> GammaN;
@@ -94,14 +104,23 @@ void ComputeGamma(const MultiFab& molarconc_in,
     }
 }
 
-void ComputeRhoWChi(const MultiFab& rho_in,
-		    const MultiFab& rhotot_in,
-		    const MultiFab& molarconc_in,
-		    MultiFab& rhoWchi_in,
-		    const MultiFab& D_bar_in)
+void ComputeGamma(const MultiFab& molarconc_in,
+		      const MultiFab& Hessian_in,
+          MultiFab& Gamma_in)
 {
-    BL_PROFILE_VAR("ComputeRhoWChi()",ComputeRhoWChi);
+    BL_PROFILE_VAR("ComputeGamma()",ComputeGamma);
+
+    NSPECIES_DISPATCH(ComputeGammaNS, molarconc_in, Hessian_in, Gamma_in);
+}
 
+// instantiated for NS species by ComputeRhoWChi (NS = 0 is generic)
+template <int NS>
+static void ComputeRhoWChiNS(const MultiFab& rho_in,
+                             const MultiFab& rhotot_in,
+                             const MultiFab& molarconc_in,
+                             MultiFab& rhoWchi_in,
+                             const MultiFab& D_bar_in)
+{
     int ng = rhoWchi_in.nGrow();
 
     // Loop over boxes
@@ -119,6 +138,7 @@ void ComputeRhoWChi(const MultiFab& rho_in,
 
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
 
             GpuArray<Real, MAX_SPECIES> rhoN;
             GpuArray<Real, MAX_SPECIES> MolarConcN;
@@ -154,14 +174,25 @@ void ComputeRhoWChi(const MultiFab& rho_in,
     }
 }
 
-void ComputeZetaByTemp(const MultiFab& molarconc_in,
- 		       const MultiFab& D_bar_in,
- 		       const MultiFab& Temp_in,
- 		       MultiFab& zeta_by_Temp_in,
- 		       const MultiFab& D_therm_in)
+void ComputeRhoWChi(const MultiFab& rho_in,
+		    const MultiFab& rhotot_in,
+		    const MultiFab& molarconc_in,
+		    MultiFab& rhoWchi_in,
+		    const MultiFab& D_bar_in)
 {
-    BL_PROFILE_VAR("ComputeZetaByTemp()",ComputeZetaByTemp);
+    BL_PROFILE_VAR("ComputeRhoWChi()",ComputeRhoWChi);
+
+    NSPECIES_DISPATCH(ComputeRhoWChiNS, rho_in, rhotot_in, molarconc_in, rhoWchi_in, D_bar_in);
+}
 
+// instantiated for NS species by ComputeZetaByTemp (NS = 0 is generic)
+template <int NS>
+static void ComputeZetaByTempNS(const MultiFab& molarconc_in,
+                                const MultiFab& D_bar_in,
+                                const MultiFab& Temp_in,
+                                MultiFab& zeta_by_Temp_in,
+                                const MultiFab& D_therm_in)
+{
     int ng = zeta_by_Temp_in.nGrow();
 
     // Loop over boxes
@@ -178,6 +209,7 @@ void ComputeZetaByTemp(const MultiFab& molarconc_in,
 
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
 
             GpuArray<Real, MAX_SPECIES> MolarConcN;
             GpuArray<Real, MAX_SPECIES> ZetaByTemp;
@@ -209,13 +241,24 @@ void ComputeZetaByTemp(const MultiFab& molarconc_in,
     }
 }
 
-void ComputeSqrtLonsagerFC(const MultiFab& rho_in,
-                          const MultiFab& rhotot_in,
-                          std::array< MultiFab, AMREX_SPACEDIM >& sqrtLonsager_fc,
-                          const Geometry& geom)
+void ComputeZetaByTemp(const MultiFab& molarconc_in,
+ 		       const MultiFab& D_bar_in,
+ 		       const MultiFab& Temp_in,
+ 		       MultiFab& zeta_by_Temp_in,
+ 		       const MultiFab& D_therm_in)
 {
-    BL_PROFILE_VAR("ComputeSqrtLonsagerFC()",ComputeSqrtLonsagerFC);
+    BL_PROFILE_VAR("ComputeZetaByTemp()",ComputeZetaByTemp);
+
+    NSPECIES_DISPATCH(ComputeZetaByTempNS, molarconc_in, D_bar_in, Temp_in, zeta_by_Temp_in, D_therm_in);
+}
 
+// instantiated for NS species by ComputeSqrtLonsagerFC (NS = 0 is generic)
+template <int NS>
+static void ComputeSqrtLonsagerFCNS(const MultiFab& rho_in,
+                                    const MultiFab& rhotot_in,
+                                    std::array< MultiFab, AMREX_SPACEDIM >& sqrtLonsager_fc,
+                                    const Geometry& geom)
+{
     const Real* dx_old = geom.CellSize();
 
     // for GPU later
@@ -242,6 +285,7 @@ void ComputeSqrtLonsagerFC(const MultiFab& rho_in,
 
         amrex::ParallelFor(box_x, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
 
             GpuArray<Real, MAX_SPECIES> RhoN;
             GpuArray<Real, MAX_SPECIES> RhoAv;
@@ -276,6 +320,8 @@ void ComputeSqrtLonsagerFC(const MultiFab& rho_in,
 
         amrex::ParallelFor(box_y, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
+
             GpuArray<Real, MAX_SPECIES> RhoN;
             GpuArray<Real, MAX_SPECIES> RhoAv;
             GpuArray<Real, MAX_SPECIES> RhoNYShift;
@@ -309,6 +355,8 @@ void ComputeSqrtLonsagerFC(const MultiFab& rho_in,
 #if (AMREX_SPACEDIM == 3)
         amrex::ParallelFor(box_z, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
+            const int nspecies = NSpecies<NS>();
+
             GpuArray<Real, MAX_SPECIES> RhoN;
             GpuArray<Real, MAX_SPECIES> RhoAv;
             GpuArray<Real, MAX_SPECIES> RhoNZShift;
@@ -345,3 +393,13 @@ void ComputeSqrtLonsagerFC(const MultiFab& rho_in,
     }
 
 }
+
+void ComputeSqrtLonsagerFC(const MultiFab& rho_in,
+                          const MultiFab& rhotot_in,
+                          std::array< MultiFab, AMREX_SPACEDIM >& sqrtLonsager_fc,
+                          const Geometry& geom)
+{
+    BL_PROFILE_VAR("ComputeSqrtLonsagerFC()",ComputeSqrtLonsagerFC);
+
+    NSPECIES_DISPATCH(ComputeSqrtLonsagerFCNS, rho_in, rhotot_in, sqrtLonsager_fc, geom);
+}
@@ -1,4 +1,5 @@
 #include "DsmcParticleContainer.H"
+#include "dsmc_functions.H"
 
 // #include "particle_functions_K.H"
 #include "paramplane_functions_K.H"
@@ -12,6 +13,12 @@ FhdParticleContainer::FhdParticleContainer(const Geometry & geom, const Distribu
 
 	realParticles = 0;
 	simParticles = 0;
+
+	// same collision streams on every rank, keyed on the global cell index
+	collideStep = 0;
+	sortCount = 0;
+	collideSeed = (seed > 0) ? seed : (amrex::Long)(amrex::Random()*4294967296.0);
+	ParallelDescriptor::Bcast(&collideSeed,1,ParallelDescriptor::IOProcessorNumber());
 	 
 	totalCollisionCells = n_cells[0]*n_cells[1]*n_cells[2];
 	domainVol = (prob_hi[0] - prob_lo[0])*(prob_hi[1] - prob_lo[1])*(prob_hi[2] - prob_lo[2]);
@@ -124,18 +131,27 @@ FhdParticleContainer::FhdParticleContainer(const Geometry & geom, const Distribu
 	{
 		domSize[d] = prob_hi[d] - prob_lo[d];
 	}
+}
 
-	const int lev=0;
-	for(MFIter mfi = MakeMFIter(lev, false); mfi.isValid(); ++mfi)
+// Apply f(i, engine) to the particles 0 ... np-1 of a tile: one GPU thread per
+// particle, or the particles shared out over the OpenMP threads, each drawing
+// from its own thread-local generator. The particles are independent, so f may
+// only touch particle i.
+template <typename F>
+static void DsmcForEachParticle (const int np, F&& f)
+{
+#ifdef AMREX_USE_GPU
+	amrex::ParallelForRNG(np, std::forward<F>(f));
+#else
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic,256)
+#endif
+	for (int i = 0; i < np; i++)
 	{
-		const Box& box = mfi.validbox();
-		const int grid_id = mfi.index();
-
-		for(int i=0;i<nspecies;i++)
-		{
-			m_cell_vectors[i][grid_id].resize(box.numPts());
-		}
+		amrex::RandomEngine engine;
+		f(i, engine);
 	}
+#endif
 }
 
 void FhdParticleContainer::MoveParticlesCPP(const Real dt, const paramPlane* paramPlaneList, const int paramPlaneCount)
@@ -143,51 +159,52 @@ void FhdParticleContainer::MoveParticlesCPP(const Real dt, const paramPlane* par
 	BL_PROFILE_VAR("MoveParticlesCPP()", MoveParticlesCPP);
 
 	const int lev = 0;
-	const GpuArray<Real, 3> dx = Geom(lev).CellSizeArray();
 	const GpuArray<Real, 3> plo = Geom(lev).ProbLoArray();
 	const GpuArray<Real, 3> phi = Geom(lev).ProbHiArray();
 
-	int np_tile = 0, np_proc = 0;
+	const Real adj = 0.99999;
+	const Real adjalt = 2.0*(1.0-0.99999);
 
-	Real adj = 0.99999;
-	Real adjalt = 2.0*(1.0-0.99999);
-	Real runtime, inttime;
-	int intsurf, intside, push;
+	// surfaces and domain size where the push kernel can read them
+	Gpu::ManagedVector<paramPlane> planes(paramPlaneCount);
+	Gpu::ManagedVector<Real> domsize(3);
+	for (int p=0; p<paramPlaneCount; ++p)
+	{
+		planes[p] = paramPlaneList[p];
+	}
+	for (int d=0; d<3; ++d)
+	{
+		domsize[d] = domSize[d];
+	}
+	const paramPlane* pplanes = planes.dataPtr();
+	Real* pdomsize = domsize.dataPtr();
 
-    int delCount[MAX_SPECIES];
-    for(int i = 0; i<MAX_SPECIES;i++)
-    {
-        delCount[i]=0;
-    }
-	
 	int totalParts = 0;
-    amrex::RandomEngine engine;
 
+	// phase one: move each particle through its surface interactions; the
+	// particles are independent, so this runs one particle per thread
 	for (FhdParIter pti(* this, lev); pti.isValid(); ++pti)
 	{
 		const int grid_id = pti.index();
 		const int tile_id = pti.LocalTileIndex();
-		const Box& tile_box  = pti.tilebox();
 
 		auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
 		auto& particles = particle_tile.GetArrayOfStructs();
-		const long np = particles.numParticles();
-
-		Box bx  = pti.tilebox();
-		IntVect myLo = bx.smallEnd();
-		IntVect myHi = bx.bigEnd();
-		
-		//cout << "Rank " << ParallelDescriptor::MyProc() << " sees " << np << " particles\n";
-		
+		const int np = particles.numParticles();
+		ParticleType* pstruct = particles().dataPtr();
+
 		totalParts += np;
 
-		for (int i = 0; i < np; i++)
+		DsmcForEachParticle(np, [=] AMREX_GPU_DEVICE (int i, amrex::RandomEngine const& engine) noexcept
 		{
-			ParticleType & part = particles[i];
-			runtime = dt*part.rdata(FHD_realData::timeFrac);
+			ParticleType & part = pstruct[i];
+			Real runtime = dt*part.rdata(FHD_realData::timeFrac);
+			Real inttime;
+			int intsurf, intside, push;
+
 			while(runtime > 0)
 			{
-				find_inter_gpu(part, runtime, paramPlaneList, paramPlaneCount,
+				find_inter_gpu(part, runtime, pplanes, paramPlaneCount,
 					&intsurf, &inttime, &intside, ZFILL(plo), ZFILL(phi));
 
 				for (int d=0; d<AMREX_SPACEDIM; ++d)
@@ -200,8 +217,8 @@ void FhdParticleContainer::MoveParticlesCPP(const Real dt, const paramPlane* par
 				if(intsurf > 0)
 				{
 					//find_inter indexes from 1 to maintain compatablity with fortran version
-					const paramPlane& surf = paramPlaneList[intsurf-1];
-      
+					const paramPlane& surf = pplanes[intsurf-1];
+
 					Real posAlt[3];
 
 					for (int d=0; d<AMREX_SPACEDIM; ++d)
@@ -210,12 +227,7 @@ void FhdParticleContainer::MoveParticlesCPP(const Real dt, const paramPlane* par
 					}
 
 					Real dummy = 1;
-                    //cout << "particle " << part.id() << " intersected " << intsurf << " with vel " << part.rdata(FHD_realData::velx) << ", " << part.rdata(FHD_realData::vely) << ", " << part.rdata(FHD_realData::velz) << endl;
-					app_bc_gpu(&surf, part, intside, domSize, &push, &runtime, dummy, engine);
-                    if(part.id() == -1)
-                    {
-                        delCount[part.idata(FHD_intData::species)]++;
-                    }
+					app_bc_gpu(&surf, part, intside, pdomsize, &push, &runtime, dummy, engine);
 					if(push == 1)
 					{
 						for (int d=0; d<AMREX_SPACEDIM; ++d)
@@ -228,49 +240,20 @@ void FhdParticleContainer::MoveParticlesCPP(const Real dt, const paramPlane* par
 
 			part.rdata(FHD_realData::timeFrac) = 1;
 
-			int cell[3];
-			cell[0] = (int)floor((part.pos(0)-plo[0])/dx[0]);
-			cell[1] = (int)floor((part.pos(1)-plo[1])/dx[1]);
-			cell[2] = (int)floor((part.pos(2)-plo[2])/dx[2]);
-
-			if((part.idata(FHD_intData::i) != cell[0]) || (part.idata(FHD_intData::j) != cell[1]) ||
-				(part.idata(FHD_intData::k) != cell[2]) || part.id() < 0 || part.idata(FHD_intData::newSpecies) != -1)
+			if(part.idata(FHD_intData::newSpecies) != -1)
 			{
-				IntVect iv(part.idata(FHD_intData::i), part.idata(FHD_intData::j), part.idata(FHD_intData::k));
-				long imap = tile_box.index(iv);
-
-				int lastIndex = m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap].size() - 1;
-				int lastPart = m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap][lastIndex];
-				int newIndex = part.idata(FHD_intData::sorted);
-
-				m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap][newIndex] = lastPart;
-				m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap].pop_back();
-
-				particles[lastPart].idata(FHD_intData::sorted) = newIndex;
-
-				part.idata(FHD_intData::sorted) = -1;
-				if(part.idata(FHD_intData::newSpecies) != -1)
-				{
-				    part.idata(FHD_intData::species) = part.idata(FHD_intData::newSpecies);
-				    part.idata(FHD_intData::newSpecies) = -1;
-				}
+			    part.idata(FHD_intData::species) = part.idata(FHD_intData::newSpecies);
+			    part.idata(FHD_intData::newSpecies) = -1;
 			}
-		}
+		});
 	}
-	
-//    for(int i = 0; i<MAX_SPECIES;i++)
-//    {
-//        int temp = delCount[i];
-//        ParallelDescriptor::ReduceIntSum(temp);
-//        if(temp != 0)
-//        {
-//            Print() << "Deleted " << temp << " of species " << i << "\n";
-//        }
-//    }
+	Gpu::streamSynchronize();
 
     ParallelDescriptor::ReduceIntSum(totalParts);
 	//Print() << "Total particles: " << totalParts << "\n";
-	
+
+	// phase two: hand the particles to their new grids and rebuild the cell
+	// index
 	Redistribute();
 	SortParticles();
 }
@@ -280,56 +263,71 @@ void FhdParticleContainer::MovePhononsCPP(const Real dt, const paramPlane* param
 	BL_PROFILE_VAR("MoveParticlesCPP()", MoveParticlesCPP);
 
 	const int lev = 0;
-	const GpuArray<Real, 3> dx = Geom(lev).CellSizeArray();
 	const GpuArray<Real, 3> plo = Geom(lev).ProbLoArray();
 	const GpuArray<Real, 3> phi = Geom(lev).ProbHiArray();
 
-	int np_tile = 0, np_proc = 0, scatterCount = 0, count = 0, specCount = 0;
+	const Real adj = 0.99999;
+	const Real adjalt = 2.0*(1.0-0.99999);
 
-	Real adj = 0.99999;
-	Real adjalt = 2.0*(1.0-0.99999);
-	Real runtime, inttime;
-	int intsurf, intside, push;
+	const Real tauI = tau_i;
+	const Real tauTA = tau_ta;
+	const Real tauLA = tau_la;
+	const Real T0 = T_init[0];
 
-    int delCount[MAX_SPECIES];
-    for(int i = 0; i<MAX_SPECIES;i++)
-    {
-        delCount[i]=0;
-    }
-	
-	int totalParts = 0;
-    amrex::RandomEngine engine;
+	// surfaces and domain size where the push kernel can read them
+	Gpu::ManagedVector<paramPlane> planes(paramPlaneCount);
+	Gpu::ManagedVector<Real> domsize(3);
+	for (int p=0; p<paramPlaneCount; ++p)
+	{
+		planes[p] = paramPlaneList[p];
+	}
+	for (int d=0; d<3; ++d)
+	{
+		domsize[d] = domSize[d];
+	}
+	const paramPlane* pplanes = planes.dataPtr();
+	Real* pdomsize = domsize.dataPtr();
+
+	int totalParts = 0, scatterCount = 0, count = 0, specCount = 0;
 
+	// phase one: move each phonon through its scattering events and surface
+	// interactions, one particle per thread
 	for (FhdParIter pti(* this, lev); pti.isValid(); ++pti)
 	{
 		const int grid_id = pti.index();
 		const int tile_id = pti.LocalTileIndex();
-		const Box& tile_box  = pti.tilebox();
 
 		auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
 		auto& particles = particle_tile.GetArrayOfStructs();
-		const long np = particles.numParticles();
-
-		Box bx  = pti.tilebox();
-		IntVect myLo = bx.smallEnd();
-		IntVect myHi = bx.bigEnd();
-		
-		//cout << "Rank " << ParallelDescriptor::MyProc() << " sees " << np << " particles\n";
-		
+		const int np = particles.numParticles();
+		ParticleType* pstruct = particles().dataPtr();
+
 		totalParts += np;
 
-		for (int i = 0; i < np; i++)
+		// event counts of each particle, summed after the push
+		Gpu::DeviceVector<int> increment_scatter(np, 0);
+		Gpu::DeviceVector<int> increment_count(np, 0);
+		Gpu::DeviceVector<int> increment_spec(np, 0);
+		int* pincrement_scatter = increment_scatter.dataPtr();
+		int* pincrement_count = increment_count.dataPtr();
+		int* pincrement_spec = increment_spec.dataPtr();
+
+		DsmcForEachParticle(np, [=] AMREX_GPU_DEVICE (int i, amrex::RandomEngine const& engine) noexcept
 		{
-			ParticleType & part = particles[i];
-			runtime = dt*part.rdata(FHD_realData::timeFrac);
+			ParticleType & part = pstruct[i];
+			Real runtime = dt*part.rdata(FHD_realData::timeFrac);
+			Real inttime;
+			int intsurf, intside, push;
+			int scatter = 0, bcCount = 0, bcSpec = 0;
+
 			while(runtime > 0)
 			{
-				find_inter_gpu(part, runtime, paramPlaneList, paramPlaneCount,
+				find_inter_gpu(part, runtime, pplanes, paramPlaneCount,
 					&intsurf, &inttime, &intside, ZFILL(plo), ZFILL(phi));
 				
-				Real tauImpurityInv = pow(part.rdata(FHD_realData::omega),4)/tau_i;
-				Real tauTAInv = part.rdata(FHD_realData::omega)*pow(T_init[0],4)/tau_ta;
-				Real tauLAInv = pow(part.rdata(FHD_realData::omega),2)*pow(T_init[0],3)/tau_la;
+				Real tauImpurityInv = pow(part.rdata(FHD_realData::omega),4)/tauI;
+				Real tauTAInv = part.rdata(FHD_realData::omega)*pow(T0,4)/tauTA;
+				Real tauLAInv = pow(part.rdata(FHD_realData::omega),2)*pow(T0,3)/tauLA;
 				Real tauNormalInv = (2.0*tauTAInv+tauLAInv)/3.0;
 				Real tauInv = tauImpurityInv + tauNormalInv;
 				
@@ -346,7 +344,7 @@ void FhdParticleContainer::MovePhononsCPP(const Real dt, const paramPlane* param
                     if(intsurf > 0)
 				    {
 					    //find_inter indexes from 1 to maintain compatablity with fortran version
-					    const paramPlane& surf = paramPlaneList[intsurf-1];
+					    const paramPlane& surf = pplanes[intsurf-1];
           
 					    Real posAlt[3];
 
@@ -355,11 +353,7 @@ void FhdParticleContainer::MovePhononsCPP(const Real dt, const paramPlane* param
 						    posAlt[d] = inttime * part.rdata(FHD_realData::velx + d)*adjalt;
 					    }
 					    
-					    app_bc_phonon_gpu(&surf, part, intside, domSize, &push, &runtime, step, &count, &specCount, engine);
-                        if(part.id() == -1)
-                        {
-                            delCount[part.idata(FHD_intData::species)]++;
-                        }
+					    app_bc_phonon_gpu(&surf, part, intside, pdomsize, &push, &runtime, step, &bcCount, &bcSpec, engine);
 					    if(push == 1)
 					    {
 						    for (int d=0; d<AMREX_SPACEDIM; ++d)
@@ -367,59 +361,32 @@ void FhdParticleContainer::MovePhononsCPP(const Real dt, const paramPlane* param
 							    part.pos(d) += part.pos(d) + posAlt[d];
 						    }
 					    }
-				    }				    
-				    
-				    
+				    }
                 }else
                 {
                     runtime = runtime - scatterTime;
-                    scatterCount++;
+                    scatter++;
                     for (int d=0; d<AMREX_SPACEDIM; ++d)
 				    {
 					    part.pos(d) += scatterTime * part.rdata(FHD_realData::velx + d)*adj;
 				    }
 				    
-				    randomSphere(&part.rdata(FHD_realData::velx),&part.rdata(FHD_realData::vely), &part.rdata(FHD_realData::velz), engine);				    
+				    randomSphere(&part.rdata(FHD_realData::velx),&part.rdata(FHD_realData::vely), &part.rdata(FHD_realData::velz), engine);
                 }
                 
 			}
 			
 			part.rdata(FHD_realData::timeFrac) = 1.0;
 
-			int cell[3];
-			cell[0] = (int)floor((part.pos(0)-plo[0])/dx[0]);
-			cell[1] = (int)floor((part.pos(1)-plo[1])/dx[1]);
-			cell[2] = (int)floor((part.pos(2)-plo[2])/dx[2]);
+			pincrement_scatter[i] = scatter;
+			pincrement_count[i] = bcCount;
+			pincrement_spec[i] = bcSpec;
+		});
 
-			if((part.idata(FHD_intData::i) != cell[0]) || (part.idata(FHD_intData::j) != cell[1]) ||
-				(part.idata(FHD_intData::k) != cell[2]) || part.id() < 0)
-			{
-				IntVect iv(part.idata(FHD_intData::i), part.idata(FHD_intData::j), part.idata(FHD_intData::k));
-				long imap = tile_box.index(iv);
-
-				int lastIndex = m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap].size() - 1;
-				int lastPart = m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap][lastIndex];
-				int newIndex = part.idata(FHD_intData::sorted);
-
-				m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap][newIndex] = lastPart;
-				m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap].pop_back();
-
-				particles[lastPart].idata(FHD_intData::sorted) = newIndex;
-
-				part.idata(FHD_intData::sorted) = -1;
-			}
-		}
+		scatterCount += Reduce::Sum(np, pincrement_scatter);
+		count += Reduce::Sum(np, pincrement_count);
+		specCount += Reduce::Sum(np, pincrement_spec);
 	}
-	
-//    for(int i = 0; i<MAX_SPECIES;i++)
-//    {
-//        int temp = delCount[i];
-//        ParallelDescriptor::ReduceIntSum(temp);
-//        if(temp != 0)
-//        {
-//            Print() << "Deleted " << temp << " of species " << i << "\n";
-//        }
-//    }
 
     ParallelDescriptor::ReduceIntSum(scatterCount);
     ParallelDescriptor::ReduceIntSum(totalParts);
@@ -431,54 +398,90 @@ void FhdParticleContainer::MovePhononsCPP(const Real dt, const paramPlane* param
     {
         Print() << "Fraction of boundary interactions which were specular: " << (double)specCount/((double)count) << "\n";
     }
-	
+
+	// phase two: hand the particles to their new grids and rebuild the cell
+	// index
 	Redistribute();
 	SortParticles();
 }
 
 void FhdParticleContainer::SortParticles()
 {
+	BL_PROFILE_VAR("SortParticles()",SortParticles);
 	int lev = 0;
 
-	const Real* dx = Geom(lev).CellSize();
-	const Real* plo = Geom(lev).ProbLo();
-	const Real* phi = Geom(lev).ProbHi();
+	const GpuArray<Real, 3> dx = Geom(lev).CellSizeArray();
+	const GpuArray<Real, 3> plo = Geom(lev).ProbLoArray();
+	const int ns = nspecies;
 
-	for (FhdParIter pti(* this, lev); pti.isValid(); ++pti)
+	auto& pmap = GetParticles(lev);
+
+	// every sort_int calls the tiles are also reordered in memory along the
+	// permutation, so the particles of a cell are contiguous
+	const bool reorder = (sort_int > 0) && (sortCount % sort_int == 0);
+	sortCount++;
+
+	// counting sort of the particles of each grid by (cell, species); as in
+	// the rest of the DSMC routines, each grid holds a single particle tile
+	for(MFIter mfi = MakeMFIter(lev, false); mfi.isValid(); ++mfi)
 	{
-		const int grid_id = pti.index();
-		const int tile_id = pti.LocalTileIndex();
-		const Box& tile_box  = pti.tilebox();
+		const int grid_id = mfi.index();
+		const Box box = mfi.validbox();
+		const Long ncell = box.numPts();
+		const Long nbins = ncell*ns;
+
+		auto ptile = pmap.find(std::make_pair(grid_id,0));
+		const int np = (ptile == pmap.end()) ? 0 : ptile->second.GetArrayOfStructs().numParticles();
+		ParticleType* pstruct = (np > 0) ? ptile->second.GetArrayOfStructs()().dataPtr() : nullptr;
+
+		DsmcCellIndex& cell_index = m_cell_index[grid_id];
+		cell_index.nspec = ns;
+		cell_index.offsets.resize(nbins+1);
+		cell_index.perm.resize(np);
+
+		Gpu::DeviceVector<int> counts(nbins+1, 0);
+		Gpu::DeviceVector<int> bins(np);
+		int* pcounts = counts.dataPtr();
+		int* pbins = bins.dataPtr();
+		int* poffsets = cell_index.offsets.dataPtr();
+		unsigned int* pperm = cell_index.perm.dataPtr();
+
+		// cell of each particle, its bin and its rank within the bin
+		amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+		{
+			ParticleType & part = pstruct[i];
+			const IntVect iv((int)floor((part.pos(0)-plo[0])/dx[0]),
+			                 (int)floor((part.pos(1)-plo[1])/dx[1]),
+			                 (int)floor((part.pos(2)-plo[2])/dx[2]));
+			part.idata(FHD_intData::i) = iv[0];
+			part.idata(FHD_intData::j) = iv[1];
+			part.idata(FHD_intData::k) = iv[2];
+			pbins[i] = box.index(iv)*ns + part.idata(FHD_intData::species);
+			part.idata(FHD_intData::sorted) = Gpu::Atomic::Add(&pcounts[pbins[i]], 1);
+		});
+
+		Gpu::exclusive_scan(counts.begin(), counts.end(), cell_index.offsets.begin());
+
+		amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+		{
+			pperm[poffsets[pbins[i]] + pstruct[i].idata(FHD_intData::sorted)] = i;
+		});
 
-		auto& particle_tile = GetParticles(lev)[std::make_pair(grid_id,tile_id)];
-		auto& particles = particle_tile.GetArrayOfStructs();
-		const long np = particles.numParticles();
+		// counts and bins go out of scope
+		Gpu::streamSynchronize();
 
-		for (int i = 0; i < np; ++ i)
+		if (reorder && np > 0)
 		{
-			ParticleType & part = particles[i];
-			IntVect iv ={0,0,0};
+			// particle k of the sorted tile is particle perm[k] of the old one,
+			// so afterwards the permutation is the identity; the bin offsets
+			// and the ranks stored in idata(sorted) move with the particles
+			ReorderParticles(lev, mfi, pperm);
 
-			if(part.idata(FHD_intData::sorted) == -1)
-			{
-				iv[0] = (int)floor((part.pos(0)-plo[0])/dx[0]);
-				iv[1] = (int)floor((part.pos(1)-plo[1])/dx[1]);
-				iv[2] = (int)floor((part.pos(2)-plo[2])/dx[2]);
-				part.idata(FHD_intData::i) = iv[0];
-				part.idata(FHD_intData::j) = iv[1];
-				part.idata(FHD_intData::k) = iv[2];
-				long imap = tile_box.index(iv);
-				part.idata(FHD_intData::sorted) = m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap].size();
-				m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap].push_back(i);
-			}
-			else
+			amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
 			{
-				iv[0] = part.idata(FHD_intData::i);
-				iv[1] = part.idata(FHD_intData::j);
-				iv[2] = part.idata(FHD_intData::k);
-				long imap = tile_box.index(iv);
-				m_cell_vectors[part.idata(FHD_intData::species)][pti.index()][imap][part.idata(FHD_intData::sorted)] = i;
-			}
+				pperm[i] = i;
+			});
+			Gpu::streamSynchronize();
 		}
 	}
 }
@@ -17,7 +17,12 @@ FhdParticleContainer::FhdParticleContainer(const Geometry & geom,
     : IBMarkerContainerBase<FHD_realData, FHD_intData>(geom, geomF, dmap, ba, baF, n_nbhd, ngF), n_list(0)
 {
     BL_PROFILE_VAR("FhdParticleContainer()",FhdParticleContainer);
-    
+
+    // cold per-particle data as struct-of-arrays components (see FHD_soaData)
+    for (int i=0; i<FHD_soaData::count; ++i) {
+        AddRealComp(true);
+    }
+
     InitInternals(n_nbhd);
     nghost = n_nbhd;
  
@@ -193,11 +198,15 @@ void FhdParticleContainer::forceFunction(Real dt)
         Real maxUtile = 0;
         Real maxDtile = 0;
 
+        auto& soa = pti.GetStructOfArrays();
+        const Real* spring = soa.GetRealData(FHD_soaData::spring).data();
+        Real* potential = soa.GetRealData(FHD_soaData::potential).data();
+
          for (int i = 0; i < np; ++i) {
 
             ParticleType & part = particles[i];
 
-            if(part.rdata(FHD_realData::spring) != 0)
+            if(spring[i] != 0)
             {
                 Real radVec[3];
                 radVec[0] = part.pos(0);
@@ -212,9 +221,9 @@ void FhdParticleContainer::forceFunction(Real dt)
 
                 //Print() << "k: " << kFac << endl;
 
-                part.rdata(FHD_realData::forcex) = part.rdata(FHD_realData::forcex) - part.rdata(FHD_realData::spring)*radVec[0];
-                part.rdata(FHD_realData::forcey) = part.rdata(FHD_realData::forcey) - part.rdata(FHD_realData::spring)*radVec[1];
-                part.rdata(FHD_realData::forcez) = part.rdata(FHD_realData::forcez) - part.rdata(FHD_realData::spring)*radVec[2];
+                part.rdata(FHD_realData::forcex) = part.rdata(FHD_realData::forcex) - spring[i]*radVec[0];
+                part.rdata(FHD_realData::forcey) = part.rdata(FHD_realData::forcey) - spring[i]*radVec[1];
+                part.rdata(FHD_realData::forcez) = part.rdata(FHD_realData::forcez) - spring[i]*radVec[2];
 
 //                part.rdata(FHD_realData::forcex) = part.rdata(FHD_realData::forcex) - kFac*radVec[0];
 //                part.rdata(FHD_realData::forcey) = part.rdata(FHD_realData::forcey) - kFac*radVec[1];
@@ -223,11 +232,11 @@ void FhdParticleContainer::forceFunction(Real dt)
                 Real dSqr = (pow(radVec[0],2) + pow(radVec[1],2) + pow(radVec[2],2));
             
 
-                part.rdata(FHD_realData::potential) = 0.5*part.rdata(FHD_realData::spring)*dSqr;
+                potential[i] = 0.5*spring[i]*dSqr;
 
-                if(part.rdata(FHD_realData::potential) > maxUtile)
+                if(potential[i] > maxUtile)
                 {
-                    maxUtile = part.rdata(FHD_realData::potential);
+                    maxUtile = potential[i];
                 }
 
                 if((dSqr/(0.5*part.rdata(FHD_realData::sigma))) > maxDtile)
@@ -273,15 +282,17 @@ void FhdParticleContainer::pinForce()
         Real maxUtile = 0;
         Real maxDtile = 0;
 
+        const Real* wetDiff = pti.GetStructOfArrays().GetRealData(FHD_soaData::wetDiff).data();
+
          for (int i = 0; i < np; ++i) {
 
             ParticleType & part = particles[i];
 
             if(part.idata(FHD_intData::pinned) != 0)
             {   
-                part.rdata(FHD_realData::forcex) += -1.0*k_B*T_init[0]*part.rdata(FHD_realData::velx)/part.rdata(FHD_realData::wetDiff);
-                part.rdata(FHD_realData::forcey) += -1.0*k_B*T_init[0]*part.rdata(FHD_realData::vely)/part.rdata(FHD_realData::wetDiff);
-                part.rdata(FHD_realData::forcez) += -1.0*k_B*T_init[0]*part.rdata(FHD_realData::velz)/part.rdata(FHD_realData::wetDiff);
+                part.rdata(FHD_realData::forcex) += -1.0*k_B*T_init[0]*part.rdata(FHD_realData::velx)/wetDiff[i];
+                part.rdata(FHD_realData::forcey) += -1.0*k_B*T_init[0]*part.rdata(FHD_realData::vely)/wetDiff[i];
+                part.rdata(FHD_realData::forcez) += -1.0*k_B*T_init[0]*part.rdata(FHD_realData::velz)/wetDiff[i];
 
                 Print() << part.rdata(FHD_realData::forcex) << ", " << part.rdata(FHD_realData::velx) << endl;
             }
@@ -355,7 +366,16 @@ void FhdParticleContainer::computeForcesNLGPU(const MultiFab& charge, const Mult
     Real rdcount = 0;
     Real recount = 0;
     Real recountI = 0;
+    Real ccount = 0;
     const int lev = 0;
+
+    // es_tog=2 with a cutoff: Coulomb forces over the neighbor list
+    // es_tog=3 in PPPM mode (p3m_alpha>0): the erfc real-space part of the
+    // Ewald split, in place of the tabulated short-range correction
+    const bool pppm = (es_tog==3 && p3m_alpha > 0);
+    const bool coulomb_nl = (es_tog==2 && coulomb_cutoff > 0) || pppm;
+    const Real nl_cutoff  = pppm ? p3m_cutoff : coulomb_cutoff;
+    const Real nl_damping = pppm ? p3m_alpha  : coulomb_damping;
        
 #ifdef _OPENMP
 #pragma omp parallel
@@ -385,12 +405,19 @@ void FhdParticleContainer::computeForcesNLGPU(const MultiFab& charge, const Mult
                               m_neighbor_list[lev][index], topList, bottomList, topListLength, bottomListLength, rcount, rdcount);           
         }
 
-        if (es_tog==3)
+        if (es_tog==3 && !pppm)
         {
             compute_p3m_sr_correction_nl_gpu(particles, Np, Nn,
                                         m_neighbor_list[lev][index], dx, recount, recountI);
 
         }
+
+        if (coulomb_nl)
+        {
+            compute_coulomb_nl_gpu(particles, Np, Nn,
+                                   m_neighbor_list[lev][index], nl_cutoff, nl_damping,
+                                   pppm ? 0 : 1, ccount);
+        }
     
     }
 
@@ -402,7 +429,7 @@ void FhdParticleContainer::computeForcesNLGPU(const MultiFab& charge, const Mult
             Print() << rcount/2 << " close range interactions.\n";
             Print() << rdcount << " wall interactions.\n";
     }
-    if(es_tog==3) 
+    if(es_tog==3 && !pppm) 
     {
             ParallelDescriptor::ReduceRealSum(recount);
             ParallelDescriptor::ReduceRealSum(recountI);
@@ -410,8 +437,16 @@ void FhdParticleContainer::computeForcesNLGPU(const MultiFab& charge, const Mult
             Print() << recount/2 << " p3m interactions.\n";
             Print() << recountI << " image charge interactions.\n";
     }
+    if(coulomb_nl) 
+    {
+            ParallelDescriptor::ReduceRealSum(ccount);
+
+            Print() << ccount/2 << " Coulomb interactions.\n";
+    }
 }
 
+// All-pairs Coulomb sum over periodic images (es_tog=2 without a
+// coulomb_cutoff); gathers every particle on every rank, so O(N^2) work
 void FhdParticleContainer::computeForcesCoulombGPU(long totalParticles) {
 
     BL_PROFILE_VAR("computeForcesCoulomb()",computeForcesCoulomb);
@@ -749,6 +784,11 @@ void FhdParticleContainer::MoveIonsCPP(const Real dt, const Real* dxFluid, const
 	    ParticleType* particles = aos().dataPtr();
             long np = this->GetParticles(lev).at(index).numParticles();
 
+            auto& soa = this->GetParticles(lev).at(index).GetStructOfArrays();
+            const Real* dryDiff   = soa.GetRealData(FHD_soaData::dryDiff).data();
+            const Real* wetDiff   = soa.GetRealData(FHD_soaData::wetDiff).data();
+            const Real* totalDiff = soa.GetRealData(FHD_soaData::totalDiff).data();
+
             amrex::ParallelForRNG(np, [=] AMREX_GPU_DEVICE (int i, amrex::RandomEngine const& engine) noexcept
             //for (int i = 0; i < np; ++ i) 
 	    {
@@ -759,9 +799,9 @@ void FhdParticleContainer::MoveIonsCPP(const Real dt, const Real* dxFluid, const
                         GpuArray<Real, 3> mbDer;
                         GpuArray<Real, 3> dry_terms;
 
-                        get_explicit_mobility_gpu(mb, mbDer, part, plo, phi);
+                        get_explicit_mobility_gpu(mb, mbDer, part, dryDiff[i], wetDiff[i], totalDiff[i], plo, phi);
                         
-                        dry_gpu(dt, part,dry_terms, mb, mbDer, engine);
+                        dry_gpu(dt, part, dryDiff[i], dry_terms, mb, mbDer, engine);
 
                         for (int d=0; d<AMREX_SPACEDIM; ++d)
                         {                   
@@ -811,6 +851,8 @@ void FhdParticleContainer::MoveIonsCPP(const Real dt, const Real* dxFluid, const
         Real* pincrement_maxdist = increment_maxdist.data();
         Real* pincrement_diffest = increment_diffest.data();
 
+        Real* travelTime = this->GetParticles(lev).at(index).GetStructOfArrays().GetRealData(FHD_soaData::travelTime).data();
+
         //reduce_op5.eval(np, reduce_data5, [=] AMREX_GPU_DEVICE (int i) -> ReduceTuple
 
 	// Set up RNG engine with ParallelForRNG, and do reduction using a np-sized vector storing value for each particle
@@ -904,9 +946,9 @@ void FhdParticleContainer::MoveIonsCPP(const Real dt, const Real* dxFluid, const
 
                 //std::cout << "MAXDIST: " << maxdist << "\n";
 
-                part.rdata(FHD_realData::travelTime) += dt;
+                travelTime[i] += dt;
 
-                pincrement_diffest[i] = totaldist/(6.0*part.rdata(FHD_realData::travelTime));
+                pincrement_diffest[i] = totaldist/(6.0*travelTime[i]);
 
                 //diffinst += diffest;
             }
@@ -1431,12 +1473,12 @@ void FhdParticleContainer::potentialDistribution(long totalParticles, const int
         auto& particles = particle_tile.GetArrayOfStructs();
         const int np = particles.numParticles();   
 
+        const Real* ppotential = particle_tile.GetStructOfArrays().GetRealData(FHD_soaData::potential).data();
+
         // loop over particles
         for (int i = 0; i < np; ++i) {
 
-            ParticleType & part = particles[i];
-
-            Real potential = part.rdata(FHD_realData::potential);
+            Real potential = ppotential[i];
 
             int bin = (int)floor(potential/binSize);
             if(bin < totalBins)
@@ -1988,6 +2030,8 @@ FhdParticleContainer::PrintParticles()
         AoS & particles = this->GetParticles(lev).at(index).GetArrayOfStructs();
         long np = this->GetParticles(lev).at(index).numParticles();
 
+        const Real* totalDiff = this->GetParticles(lev).at(index).GetStructOfArrays().GetRealData(FHD_soaData::totalDiff).data();
+
         for(int i=0; i<np; ++i)
         {
             ParticleType & part = particles[i];
@@ -1995,7 +2039,7 @@ FhdParticleContainer::PrintParticles()
             if(part.idata(FHD_intData::pinned) == 0)
             {
 
-            double bigM  = part.rdata(FHD_realData::totalDiff)/(T_init[0]*k_B);
+            double bigM  = totalDiff[i]/(T_init[0]*k_B);
             double absForce = sqrt(part.rdata(FHD_realData::forcex)*part.rdata(FHD_realData::forcex) + part.rdata(FHD_realData::forcey)*part.rdata(FHD_realData::forcey) + part.rdata(FHD_realData::forcez)*part.rdata(FHD_realData::forcez));
 
             std::cout << scientific << setprecision(15) << "Particle " << ParallelDescriptor::MyProc() << ", " << part.id() << ", force: " << part.rdata(FHD_realData::forcex) << ", " << part.rdata(FHD_realData::forcey) << ", " << part.rdata(FHD_realData::forcez) << ", " << absForce << std::endl;
@@ -2473,6 +2517,12 @@ FhdParticleContainer::MeanSqrCalc(int lev, int step) {
         AoS & particles = this->GetParticles(lev).at(index).GetArrayOfStructs();
         long np = this->GetParticles(lev).at(index).numParticles();
         nTotal += np;
+
+        auto& soa = this->GetParticles(lev).at(index).GetStructOfArrays();
+        Real* ox = soa.GetRealData(FHD_soaData::ox).data();
+        Real* oy = soa.GetRealData(FHD_soaData::oy).data();
+        Real* oz = soa.GetRealData(FHD_soaData::oz).data();
+        Real* ptravelTime = soa.GetRealData(FHD_soaData::travelTime).data();
         
         for (int i=0; i<np; ++i) {
             ParticleType & part = particles[i];
@@ -2481,9 +2531,9 @@ FhdParticleContainer::MeanSqrCalc(int lev, int step) {
             if(stepstat[spec] == 0)
             {
                 for (int d=0; d<AMREX_SPACEDIM; ++d){
-                    part.rdata(FHD_realData::ox + d) = part.rdata(FHD_realData::ax + d);
+                    soa.GetRealData(FHD_soaData::ox + d)[i] = part.rdata(FHD_realData::ax + d);
                 }
-                part.rdata(FHD_realData::travelTime) = 0;
+                ptravelTime[i] = 0;
             }        
         }
 
@@ -2492,16 +2542,16 @@ FhdParticleContainer::MeanSqrCalc(int lev, int step) {
 
             int spec = part.idata(FHD_intData::species)-1;
 
-            Real dispX = pow(part.rdata(FHD_realData::ax)-part.rdata(FHD_realData::ox),2);          
-            Real dispY = pow(part.rdata(FHD_realData::ay)-part.rdata(FHD_realData::oy),2);
-            Real dispZ = pow(part.rdata(FHD_realData::az)-part.rdata(FHD_realData::oz),2);
+            Real dispX = pow(part.rdata(FHD_realData::ax)-ox[i],2);          
+            Real dispY = pow(part.rdata(FHD_realData::ay)-oy[i],2);
+            Real dispZ = pow(part.rdata(FHD_realData::az)-oz[i],2);
 
             sqrDispX[spec] += dispX;
             sqrDispY[spec] += dispY;
             sqrDispZ[spec] += dispZ;
             sqrDisp[spec] += dispX + dispY + dispZ;
 
-            travelTime[spec] = part.rdata(FHD_realData::travelTime);
+            travelTime[spec] = ptravelTime[i];
             specCount[spec]++;
 
         }
@@ -6,6 +6,7 @@
 int         dsmc::sim_type;
 amrex::Real dsmc::hbar;
 amrex::Real dsmc::debye_group_velocity;
+int         dsmc::sort_int;
 
 void InitializeDsmcNamespace() {
 
@@ -18,6 +19,9 @@ void InitializeDsmcNamespace() {
     // weighting of pressure when computing norms and inner products
     debye_group_velocity = 1;
 
+    // physical reordering of the particles by cell (0 = never)
+    sort_int = 0;
+
     ParmParse pp;
 
     // pp.query searches for optional parameters
@@ -27,4 +31,5 @@ void InitializeDsmcNamespace() {
     pp.query("sim_type",sim_type);
     pp.query("hbar",hbar);
     pp.query("debye_group_velocity",debye_group_velocity);
+    pp.query("sort_int",sort_int);
 }
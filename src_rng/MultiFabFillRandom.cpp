@@ -2,6 +2,11 @@
 
 #include "rng_functions.H"
 
+#include "CounterRNG.H"
+
+// key for the counter-based noise in MultiFabFillRandomNormal
+static amrex::ULong noise_seed = 0;
+
 void MultiFabFillRandom(MultiFab& mf, const int& comp, const amrex::Real& variance,
                         const Geometry& geom, const int& ng)
 {
@@ -29,3 +34,76 @@ void MultiFabFillRandom(MultiFab& mf, const int& comp, const amrex::Real& varian
 
 //----------------------------------------
 }
+
+void InitRandomNoise(const amrex::ULong& seed)
+{
+    noise_seed = seed;
+}
+
+void MultiFabFillRandomNormal(MultiFab& mf, const int& comp, const int& ncomp,
+                              const Vector<Real>& variance, const Geometry& geom,
+                              const int& step, const int& field)
+{
+    BL_PROFILE_VAR("MultiFabFillRandomNormal()",MultiFabFillRandomNormal);
+
+    // ghost cells on non-periodic sides are indexed with this offset
+    const int margin = 8;
+
+    if (mf.nGrow() > margin) {
+        Abort("MultiFabFillRandomNormal: too many ghost cells");
+    }
+    if (field < 0 || field >= 65536 || comp+ncomp > 65536) {
+        Abort("MultiFabFillRandomNormal: field and component must fit in 16 bits");
+    }
+
+    // the sample at (i,j,k,n) only depends on (seed, step, field, n) and the
+    // global index of (i,j,k) wrapped into the domain, so faces/nodes shared by
+    // two boxes and periodic images get identical values without communication,
+    // ghost cells are generated locally, and the result does not depend on the
+    // domain decomposition
+    const Box& domain = geom.Domain();
+    GpuArray<int,AMREX_SPACEDIM> dlo, len, per;
+    GpuArray<Long,AMREX_SPACEDIM> ext;
+    for (int d=0; d<AMREX_SPACEDIM; ++d) {
+        dlo[d] = domain.smallEnd(d);
+        len[d] = domain.length(d);
+        per[d] = geom.isPeriodic(d);
+        ext[d] = per[d] ? len[d] : len[d] + 1 + 2*margin;
+    }
+
+    const GpuArray<std::uint32_t,2> key = {static_cast<std::uint32_t>(noise_seed),
+                                           static_cast<std::uint32_t>(noise_seed >> 32)};
+    const std::uint32_t stream = static_cast<std::uint32_t>(field) << 16;
+    const std::uint32_t ustep = static_cast<std::uint32_t>(step);
+
+    Gpu::DeviceVector<Real> stddev(ncomp);
+    {
+        Vector<Real> stddev_h(ncomp);
+        for (int n=0; n<ncomp; ++n) {
+            stddev_h[n] = std::sqrt(variance[n]);
+        }
+        Gpu::copy(Gpu::hostToDevice, stddev_h.begin(), stddev_h.end(), stddev.begin());
+    }
+    const Real* stddev_p = stddev.data();
+
+    for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.growntilebox();
+        const Array4<Real>& mf_fab = mf.array(mfi);
+        amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            Long gidx = 0;
+            for (int d=AMREX_SPACEDIM-1; d>=0; --d) {
+                int id = iv[d] - dlo[d];
+                id = per[d] ? ((id % len[d]) + len[d]) % len[d] : id + margin;
+                gidx = gidx*ext[d] + id;
+            }
+            const GpuArray<std::uint32_t,4> ctr = {static_cast<std::uint32_t>(gidx),
+                                                   static_cast<std::uint32_t>(gidx >> 32),
+                                                   stream | static_cast<std::uint32_t>(comp+n),
+                                                   ustep};
+            mf_fab(i,j,k,comp+n) = stddev_p[n]*philox_normal(ctr,key);
+        });
+    }
+    Gpu::streamSynchronize();
+}